@@ -9,6 +9,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/HW/SI.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "DiscIO/Blob.h"
 #include "DiscIO/NANDContentLoader.h"
 
 SConfig* SConfig::m_Instance;
@@ -587,6 +588,8 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("BBDumpPort",                &m_LocalCoreStartupParameter.iBBDumpPort,       -1);
 	core->Get("SyncGPU",                   &m_LocalCoreStartupParameter.bSyncGPU,          false);
 	core->Get("FastDiscSpeed",             &m_LocalCoreStartupParameter.bFastDiscSpeed,    false);
+	core->Get("MapDiscImages",             &m_LocalCoreStartupParameter.bMapDiscImages,    false);
+	DiscIO::SetMapPlainImages(m_LocalCoreStartupParameter.bMapDiscImages);
 	core->Get("DCBZ",                      &m_LocalCoreStartupParameter.bDCBZOFF,          false);
 	core->Get("FrameLimit",                &m_Framelimit,                                  1); // auto frame limit by default
 	core->Get("Overclock",                 &m_OCFactor,                                    1.0f);
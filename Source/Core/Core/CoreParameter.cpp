@@ -42,7 +42,7 @@ SCoreStartupParameter::SCoreStartupParameter()
   bRunCompareServer(false), bRunCompareClient(false),
   bMMU(false), bDCBZOFF(false),
   iBBDumpPort(0),
-  bSyncGPU(false), bFastDiscSpeed(false),
+  bSyncGPU(false), bFastDiscSpeed(false), bMapDiscImages(false),
   SelectedLanguage(0), bWii(false),
   bConfirmStop(false), bHideCursor(false),
   bAutoHideCursor(false), bUsePanicHandlers(true), bOnScreenDisplayMessages(true),
@@ -80,6 +80,7 @@ void SCoreStartupParameter::LoadDefaults()
 	iBBDumpPort = -1;
 	bSyncGPU = false;
 	bFastDiscSpeed = false;
+	bMapDiscImages = false;
 	bEnableMemcardSaving = true;
 	SelectedLanguage = 0;
 	bWii = false;
@@ -177,6 +177,7 @@ struct SCoreStartupParameter
 	int iBBDumpPort;
 	bool bSyncGPU;
 	bool bFastDiscSpeed;
+	bool bMapDiscImages;
 
 	int SelectedLanguage;
 
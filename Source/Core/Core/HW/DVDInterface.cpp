@@ -4,10 +4,17 @@
 
 #include <cinttypes>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "AudioCommon/AudioCommon.h"
 
 #include "Common/CommonTypes.h"
+#include "Common/Thread.h"
+#include "Common/Timer.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -267,6 +274,35 @@ static unsigned char media_buffer[0x40];
 static int ejectDisc;
 static int insertDisc;
 
+// The disc is read on the DVD thread as soon as a read command is executed, so the host
+// I/O overlaps with the emulated read time. The data is copied to emulated RAM when the
+// command finishes, as before, which is also the only time the CPU thread may have to wait.
+enum AsyncReadState
+{
+	ASYNC_READ_IDLE,
+	ASYNC_READ_QUEUED,
+	ASYNC_READ_READING,
+	ASYNC_READ_DONE,
+};
+
+static std::thread s_dvd_thread;
+static std::mutex s_dvd_mutex;
+static std::condition_variable s_dvd_cv;
+static std::condition_variable s_dvd_done_cv;
+static bool s_dvd_thread_running = false;
+
+static AsyncReadState s_async_read_state = ASYNC_READ_IDLE;
+static u64 s_async_read_offset;
+static u32 s_async_read_length;
+static bool s_async_read_decrypt;
+static bool s_async_read_success;
+static std::vector<u8> s_async_read_buffer;
+
+// How often emulation had to wait for the host
+static u64 s_async_reads;
+static u64 s_async_reads_waited;
+static u64 s_async_read_wait_us;
+
 void EjectDiscCallback(u64 userdata, int cyclesLate);
 void InsertDiscCallback(u64 userdata, int cyclesLate);
 
@@ -312,6 +348,118 @@ void DoState(PointerWrap &p)
 	p.Do(g_bStopAtTrackEnd);
 }
 
+static void DVDThread()
+{
+	Common::SetCurrentThreadName("DVD thread");
+
+	std::unique_lock<std::mutex> lk(s_dvd_mutex);
+	while (true)
+	{
+		s_dvd_cv.wait(lk, [] { return !s_dvd_thread_running || s_async_read_state == ASYNC_READ_QUEUED; });
+		if (!s_dvd_thread_running)
+			return;
+
+		s_async_read_state = ASYNC_READ_READING;
+		u64 offset = s_async_read_offset;
+		u32 length = s_async_read_length;
+		bool decrypt = s_async_read_decrypt;
+		lk.unlock();
+
+		bool success = VolumeHandler::ReadToPtr(s_async_read_buffer.data(), offset, length, decrypt);
+
+		lk.lock();
+		s_async_read_success = success;
+		s_async_read_state = ASYNC_READ_DONE;
+		s_dvd_done_cv.notify_all();
+	}
+}
+
+static void StartDVDThread()
+{
+	s_dvd_thread_running = true;
+	s_dvd_thread = std::thread(DVDThread);
+}
+
+static void StopDVDThread()
+{
+	if (!s_dvd_thread.joinable())
+		return;
+
+	WaitForAsyncRead();
+	{
+		std::lock_guard<std::mutex> lk(s_dvd_mutex);
+		s_dvd_thread_running = false;
+		s_async_read_state = ASYNC_READ_IDLE;
+	}
+	s_dvd_cv.notify_one();
+	s_dvd_thread.join();
+
+	INFO_LOG(DVDINTERFACE, "%" PRIu64 " disc reads, emulation waited for %" PRIu64 " of them for %" PRIu64 " ms in total",
+	         s_async_reads, s_async_reads_waited, s_async_read_wait_us / 1000);
+}
+
+void WaitForAsyncRead()
+{
+	std::unique_lock<std::mutex> lk(s_dvd_mutex);
+	s_dvd_done_cv.wait(lk, [] { return s_async_read_state != ASYNC_READ_QUEUED && s_async_read_state != ASYNC_READ_READING; });
+}
+
+static void StartAsyncRead(u64 DVD_offset, u32 length, bool decrypt)
+{
+	if (!s_dvd_thread_running)
+		return;
+
+	// Only one read command is executed at a time, but don't rely on it
+	WaitForAsyncRead();
+
+	{
+		std::lock_guard<std::mutex> lk(s_dvd_mutex);
+		s_async_read_offset = DVD_offset;
+		s_async_read_length = length;
+		s_async_read_decrypt = decrypt;
+		s_async_read_buffer.resize(length);
+		s_async_read_state = ASYNC_READ_QUEUED;
+	}
+	s_dvd_cv.notify_one();
+}
+
+// Copies the data of a read started with StartAsyncRead to emulated RAM,
+// waiting for the DVD thread if it isn't done yet.
+static bool FinishAsyncRead(u64 DVD_offset, u32 output_address, u32 length, bool decrypt)
+{
+	std::unique_lock<std::mutex> lk(s_dvd_mutex);
+
+	if (s_async_read_state == ASYNC_READ_IDLE || s_async_read_offset != DVD_offset ||
+	    s_async_read_length != length || s_async_read_decrypt != decrypt)
+	{
+		// Not started, for example because the command comes from a savestate
+		s_dvd_done_cv.wait(lk, [] { return s_async_read_state != ASYNC_READ_QUEUED && s_async_read_state != ASYNC_READ_READING; });
+		s_async_read_state = ASYNC_READ_IDLE;
+		lk.unlock();
+		return DVDRead(DVD_offset, output_address, length, decrypt);
+	}
+
+	s_async_reads++;
+	if (s_async_read_state != ASYNC_READ_DONE)
+	{
+		u64 start = Common::Timer::GetTimeUs();
+		s_dvd_done_cv.wait(lk, [] { return s_async_read_state == ASYNC_READ_DONE; });
+		s_async_reads_waited++;
+		s_async_read_wait_us += Common::Timer::GetTimeUs() - start;
+	}
+
+	s_async_read_state = ASYNC_READ_IDLE;
+	if (!s_async_read_success)
+		return false;
+
+	u8* ptr = Memory::GetPointer(output_address);
+	if (!ptr)
+		return false;
+
+	memcpy(ptr, s_async_read_buffer.data(), length);
+	return true;
+}
+
 static void FinishExecuteCommand(u64 userdata, int cyclesLate)
 {
 	if (m_DICR.TSTART)
@@ -331,8 +479,8 @@ static void FinishExecuteReadCommand(u64 userdata, int cyclesLate)
 	else
 	{
 		// Here is the actual disc reading
-		if (!DVDRead(current_read_command.DVD_offset, current_read_command.output_address,
-		             current_read_command.length, current_read_command.decrypt))
+		if (!FinishAsyncRead(current_read_command.DVD_offset, current_read_command.output_address,
+		                     current_read_command.length, current_read_command.decrypt))
 		{
 			PanicAlertT("Can't read from DVD_Plugin - DVD-Interface: Fatal Error");
 		}
@@ -445,10 +593,16 @@ void Init()
 	dtk = CoreTiming::RegisterEvent("StreamingTimer", DTKStreamingCallback);
 
 	CoreTiming::ScheduleEvent(0, dtk);
+
+	s_async_reads = 0;
+	s_async_reads_waited = 0;
+	s_async_read_wait_us = 0;
+	StartDVDThread();
 }
 
 void Shutdown()
 {
+	StopDVDThread();
 }
 
 void SetDiscInside(bool _DiscInside)
@@ -1274,6 +1428,7 @@ void ExecuteCommand(u32 command_0, u32 command_1, u32 command_2, u32 output_addr
 		read_command.callback_event_type = callback_event_type;
 		read_command.interrupt_type = interrupt_type;
 		current_read_command = read_command;
+		StartAsyncRead(read_command.DVD_offset, read_command.length, read_command.decrypt);
 		CoreTiming::ScheduleEvent((int)ticks_until_completion, finish_execute_read_command);
 	}
 	else
@@ -2,8 +2,11 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
+#include <vector>
 #include "Common/ChunkFile.h"
+#include "Common/Hash.h"
 #include "Common/StdMakeUnique.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -13,6 +16,12 @@
 #define SIZE_TO_Mb (1024 * 8 * 16)
 #define MC_HDR_SIZE 0xA000
 
+// The blocks of a flush are written to the journal before they are written to the card file, and the
+// journal is deleted afterwards. If Dolphin dies halfway through a flush, the complete journal is
+// replayed the next time the card is opened, an incomplete one means the card file wasn't touched yet.
+// Format: magic, number of blocks, (block index, block data) for each block, Adler-32 of everything before.
+static const u32 JOURNAL_MAGIC = 0x4A434D44; // "DMCJ"
+
 MemoryCard::MemoryCard(std::string filename, int _card_index, u16 sizeMb)
 	: MemoryCardBase(_card_index, sizeMb)
 	, m_filename(filename)
@@ -28,6 +37,10 @@ MemoryCard::MemoryCard(std::string filename, int _card_index, u16 sizeMb)
 
 		INFO_LOG(EXPANSIONINTERFACE, "Reading memory card %s", m_filename.c_str());
 		pFile.ReadBytes(&m_memcard_data[0], memory_card_size);
+		pFile.Close();
+
+		m_dirty_blocks.resize(memory_card_size / BLOCK_SIZE);
+		ReplayJournal();
 	}
 	else
 	{
@@ -41,6 +54,10 @@ MemoryCard::MemoryCard(std::string filename, int _card_index, u16 sizeMb)
 		memset(&m_memcard_data[MC_HDR_SIZE], 0xFF, memory_card_size - MC_HDR_SIZE);
 
 		INFO_LOG(EXPANSIONINTERFACE, "No memory card found - a new one was created.");
+
+		// A journal without its card is useless
+		File::Delete(GetJournalFilename());
+		m_dirty_blocks.resize(memory_card_size / BLOCK_SIZE);
 	}
 
 	// Class members (including inherited ones) have now been initialized, so
@@ -115,11 +132,53 @@ void MemoryCard::FlushThread()
 			return;
 		}
 
+		// Only the dirty blocks are copied, so the lock is held for as short as possible.
+		const bool whole_card = pFile.GetSize() != memory_card_size;
+		std::vector<u32> blocks;
 		{
 			std::unique_lock<std::mutex> l(m_flush_mutex);
-			memcpy(&m_flush_buffer[0], &m_memcard_data[0], memory_card_size);
+			if (whole_card)
+				MarkAllBlocksDirty();
+
+			for (u32 i = 0; i < m_dirty_blocks.size(); i++)
+			{
+				if (!m_dirty_blocks[i])
+					continue;
+
+				memcpy(&m_flush_buffer[i * BLOCK_SIZE], &m_memcard_data[i * BLOCK_SIZE], BLOCK_SIZE);
+				m_dirty_blocks[i] = false;
+				blocks.push_back(i);
+			}
+		}
+
+		// A file which didn't have the whole card in it yet has nothing worth protecting
+		const bool journaled = !whole_card && !blocks.empty() && WriteJournal(blocks);
+
+		// Adjacent blocks are written at once
+		for (size_t i = 0; i < blocks.size();)
+		{
+			size_t run = 1;
+			while (i + run < blocks.size() && blocks[i + run] == blocks[i] + run)
+				run++;
+
+			pFile.Seek((u64)blocks[i] * BLOCK_SIZE, SEEK_SET);
+			pFile.WriteBytes(&m_flush_buffer[blocks[i] * BLOCK_SIZE], run * BLOCK_SIZE);
+			i += run;
+		}
+		pFile.Flush();
+
+		if (!pFile.IsGood())
+		{
+			// Try these blocks again with the next flush
+			std::unique_lock<std::mutex> l(m_flush_mutex);
+			for (u32 block : blocks)
+				m_dirty_blocks[block] = true;
+			MakeDirty();
+		}
+		else if (journaled)
+		{
+			File::Delete(GetJournalFilename());
 		}
-		pFile.WriteBytes(&m_flush_buffer[0], memory_card_size);
 
 		if (!do_exit)
 		{
@@ -140,6 +199,101 @@ void MemoryCard::MakeDirty()
 	m_dirty.Set();
 }
 
+void MemoryCard::MarkBlocksDirty(u32 address, u32 length)
+{
+	if (length == 0)
+		return;
+
+	u32 last = std::min<u32>((address + length - 1) / BLOCK_SIZE, (u32)m_dirty_blocks.size() - 1);
+	for (u32 i = address / BLOCK_SIZE; i <= last; i++)
+		m_dirty_blocks[i] = true;
+}
+
+void MemoryCard::MarkAllBlocksDirty()
+{
+	m_dirty_blocks.assign(m_dirty_blocks.size(), true);
+}
+
+bool MemoryCard::WriteJournal(const std::vector<u32>& blocks)
+{
+	std::vector<u8> journal(2 * sizeof(u32) + blocks.size() * (sizeof(u32) + BLOCK_SIZE));
+	u8* ptr = journal.data();
+	auto put32 = [&](u32 value) { memcpy(ptr, &value, sizeof(value)); ptr += sizeof(value); };
+
+	put32(JOURNAL_MAGIC);
+	put32((u32)blocks.size());
+	for (u32 block : blocks)
+	{
+		put32(block);
+		memcpy(ptr, &m_flush_buffer[block * BLOCK_SIZE], BLOCK_SIZE);
+		ptr += BLOCK_SIZE;
+	}
+	u32 hash = HashAdler32(journal.data(), journal.size());
+
+	File::IOFile journal_file(GetJournalFilename(), "wb");
+	return journal_file.WriteBytes(journal.data(), journal.size()) && journal_file.WriteArray(&hash, 1) &&
+	       journal_file.Flush();
+}
+
+void MemoryCard::ReplayJournal()
+{
+	const std::string journal_filename = GetJournalFilename();
+	if (!File::Exists(journal_filename))
+		return;
+
+	std::string journal;
+	File::ReadFileToString(journal_filename, journal);
+
+	u32 magic = 0, num_blocks = 0, hash = 0;
+	const size_t header_size = 2 * sizeof(u32);
+	if (journal.size() >= header_size)
+	{
+		memcpy(&magic, &journal[0], sizeof(u32));
+		memcpy(&num_blocks, &journal[sizeof(u32)], sizeof(u32));
+	}
+
+	const size_t entries_size = (size_t)num_blocks * (sizeof(u32) + BLOCK_SIZE);
+	if (magic != JOURNAL_MAGIC || num_blocks > m_dirty_blocks.size() ||
+	    journal.size() != header_size + entries_size + sizeof(u32))
+	{
+		// The flush didn't get to the card file, so it's still consistent
+		WARN_LOG(EXPANSIONINTERFACE, "Discarding incomplete memory card journal %s", journal_filename.c_str());
+		File::Delete(journal_filename);
+		return;
+	}
+
+	memcpy(&hash, &journal[header_size + entries_size], sizeof(u32));
+	if (hash != HashAdler32((const u8*)journal.data(), header_size + entries_size))
+	{
+		WARN_LOG(EXPANSIONINTERFACE, "Discarding corrupt memory card journal %s", journal_filename.c_str());
+		File::Delete(journal_filename);
+		return;
+	}
+
+	File::IOFile card_file(m_filename, "r+b");
+	const char* ptr = &journal[header_size];
+	for (u32 i = 0; i < num_blocks; i++)
+	{
+		u32 block;
+		memcpy(&block, ptr, sizeof(u32));
+		ptr += sizeof(u32);
+
+		if (block < m_dirty_blocks.size())
+		{
+			memcpy(&m_memcard_data[block * BLOCK_SIZE], ptr, BLOCK_SIZE);
+			card_file.Seek((u64)block * BLOCK_SIZE, SEEK_SET);
+			card_file.WriteBytes(ptr, BLOCK_SIZE);
+		}
+		ptr += BLOCK_SIZE;
+	}
+
+	if (card_file.Flush() && card_file.IsGood())
+	{
+		NOTICE_LOG(EXPANSIONINTERFACE, "Recovered %u blocks of memory card %s from its journal", num_blocks, m_filename.c_str());
+		File::Delete(journal_filename);
+	}
+}
+
 s32 MemoryCard::Read(u32 srcaddress, s32 length, u8 *destaddress)
 {
 	if (!IsAddressInBounds(srcaddress))
@@ -165,6 +319,7 @@ s32 MemoryCard::Write(u32 destaddress, s32 length, u8 *srcaddress)
 	{
 		std::unique_lock<std::mutex> l(m_flush_mutex);
 		memcpy(&m_memcard_data[destaddress], srcaddress, length);
+		MarkBlocksDirty(destaddress, length);
 	}
 	MakeDirty();
 	return length;
@@ -182,6 +337,7 @@ void MemoryCard::ClearBlock(u32 address)
 	{
 		std::unique_lock<std::mutex> l(m_flush_mutex);
 		memset(&m_memcard_data[address], 0xFF, BLOCK_SIZE);
+		MarkBlocksDirty(address, BLOCK_SIZE);
 	}
 	MakeDirty();
 }
@@ -191,6 +347,7 @@ void MemoryCard::ClearAll()
 	{
 		std::unique_lock<std::mutex> l(m_flush_mutex);
 		memset(&m_memcard_data[0], 0xFF, memory_card_size);
+		MarkAllBlocksDirty();
 	}
 	MakeDirty();
 }
@@ -200,4 +357,11 @@ void MemoryCard::DoState(PointerWrap &p)
 	p.Do(card_index);
 	p.Do(memory_card_size);
 	p.DoArray(&m_memcard_data[0], memory_card_size);
+
+	// The loaded card can differ anywhere from the file, so the next flush has to write all of it
+	if (p.GetMode() == PointerWrap::MODE_READ)
+	{
+		std::unique_lock<std::mutex> l(m_flush_mutex);
+		MarkAllBlocksDirty();
+	}
 }
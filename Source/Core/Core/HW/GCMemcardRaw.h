@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Common/Thread.h"
@@ -27,9 +28,19 @@ public:
 	void DoState(PointerWrap &p) override;
 
 private:
+	// Both have to be called with m_flush_mutex held
+	void MarkBlocksDirty(u32 address, u32 length);
+	void MarkAllBlocksDirty();
+
+	void ReplayJournal();
+	bool WriteJournal(const std::vector<u32>& blocks);
+	std::string GetJournalFilename() const { return m_filename + ".journal"; }
+
 	std::string m_filename;
 	std::unique_ptr<u8[]> m_memcard_data;
 	std::unique_ptr<u8[]> m_flush_buffer;
+	// Blocks written since the last flush; only these are copied and written to the file.
+	std::vector<bool> m_dirty_blocks;
 	std::thread m_flush_thread;
 	std::mutex m_flush_mutex;
 	Common::Event m_flush_trigger;
@@ -2,11 +2,14 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <lzo/lzo1x.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
 #include "Common/Event.h"
 #include "Common/StringUtil.h"
 #include "Common/Timer.h"
@@ -41,12 +44,10 @@ static const u32 IN_LEN = 128 * 1024u;
 
 static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
-static unsigned char __LZO_MMODEL out[OUT_LEN];
-
-#define HEAP_ALLOC(var, size) \
-	lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
-
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+// Every chunk of IN_LEN bytes is compressed on its own, so several chunks can be compressed
+// and decompressed at the same time. They are handled in batches to bound the memory used.
+static const size_t CHUNKS_PER_BATCH = 64;
+static const size_t MIN_CHUNKS_PER_THREAD = 4;
 
 static std::string g_last_filename;
 
@@ -64,7 +65,7 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 static std::thread g_save_thread;
 
 // Don't forget to increase this after doing changes on the savestate system
-static const u32 STATE_VERSION = 40;
+static const u32 STATE_VERSION = 41;
 
 enum
 {
@@ -206,6 +207,101 @@ static std::map<double, int> GetSavedStates()
 	return m;
 }
 
+// Calls func(begin, end) on adjacent ranges of [0, count) on several threads, the calling thread takes the first one.
+template <typename F>
+static void RunOnThreads(size_t count, F func)
+{
+	int num_threads = std::max(1, std::min<int>(cpu_info.num_cores, (int)(count / MIN_CHUNKS_PER_THREAD)));
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < num_threads; t++)
+		threads.emplace_back(func, count * t / num_threads, count * (t + 1) / num_threads);
+	func(0, count / num_threads);
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+// The last chunk is always shorter than IN_LEN, and empty if the size is a multiple of it.
+static void CompressAndWriteChunks(File::IOFile& f, const u8* buffer_data, size_t buffer_size)
+{
+	const size_t num_chunks = buffer_size / IN_LEN + 1;
+	std::vector<std::vector<u8>> out(std::min(num_chunks, CHUNKS_PER_BATCH));
+	std::vector<lzo_uint32> out_len(out.size());
+
+	for (size_t batch = 0; batch < num_chunks; batch += CHUNKS_PER_BATCH)
+	{
+		const size_t count = std::min(CHUNKS_PER_BATCH, num_chunks - batch);
+		RunOnThreads(count, [&](size_t begin, size_t end)
+		{
+			std::vector<lzo_align_t> wrkmem((LZO1X_1_MEM_COMPRESS + sizeof(lzo_align_t) - 1) / sizeof(lzo_align_t));
+			for (size_t i = begin; i < end; i++)
+			{
+				const size_t offset = (batch + i) * IN_LEN;
+				const lzo_uint32 cur_len = (lzo_uint32)std::min<size_t>(IN_LEN, buffer_size - offset);
+				lzo_uint len = 0;
+
+				out[i].resize(OUT_LEN);
+				if (lzo1x_1_compress(buffer_data + offset, cur_len, out[i].data(), &len, wrkmem.data()) != LZO_E_OK)
+					PanicAlertT("Internal LZO Error - compression failed");
+				out_len[i] = (lzo_uint32)len;
+			}
+		});
+
+		for (size_t i = 0; i < count; i++)
+		{
+			// The size of the data to write is 'out_len'
+			f.WriteArray(&out_len[i], 1);
+			f.WriteBytes(out[i].data(), out_len[i]);
+		}
+	}
+}
+
+static bool ReadAndDecompressChunks(File::IOFile& f, std::vector<u8>& buffer)
+{
+	std::vector<std::vector<u8>> in(CHUNKS_PER_BATCH);
+	std::vector<int> results(CHUNKS_PER_BATCH);
+	std::vector<lzo_uint> new_len(CHUNKS_PER_BATCH);
+
+	for (size_t batch = 0; ; batch += CHUNKS_PER_BATCH)
+	{
+		size_t count = 0;
+		for (; count < CHUNKS_PER_BATCH; count++)
+		{
+			lzo_uint32 cur_len = 0;  // number of bytes to read
+			if (!f.ReadArray(&cur_len, 1))
+				break;
+
+			in[count].resize(cur_len);
+			f.ReadBytes(in[count].data(), cur_len);
+		}
+
+		RunOnThreads(count, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const size_t offset = (batch + i) * IN_LEN;
+				new_len[i] = offset < buffer.size() ? std::min<size_t>(IN_LEN, buffer.size() - offset) : 0;
+				results[i] = lzo1x_decompress_safe(in[i].data(), in[i].size(), buffer.data() + std::min(offset, buffer.size()),
+				                                   &new_len[i], nullptr);
+			}
+		});
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (results[i] != LZO_E_OK)
+			{
+				// This doesn't seem to happen anymore.
+				PanicAlertT("Internal LZO Error - decompression failed (%d) (%li, %li) \n"
+					"Try loading the state again", results[i], (long)((batch + i) * IN_LEN), (long)new_len[i]);
+				return false;
+			}
+		}
+
+		if (count < CHUNKS_PER_BATCH)
+			return true;
+	}
+}
+
 struct CompressAndDumpState_args
 {
 	std::vector<u8>* buffer_vector;
@@ -264,33 +360,7 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
 
 	if (header.size != 0) // non-zero header size means the state is compressed
 	{
-		lzo_uint i = 0;
-		while (true)
-		{
-			lzo_uint32 cur_len = 0;
-			lzo_uint out_len = 0;
-
-			if ((i + IN_LEN) >= buffer_size)
-			{
-				cur_len = (lzo_uint32)(buffer_size - i);
-			}
-			else
-			{
-				cur_len = IN_LEN;
-			}
-
-			if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-				PanicAlertT("Internal LZO Error - compression failed");
-
-			// The size of the data to write is 'out_len'
-			f.WriteArray((lzo_uint32*)&out_len, 1);
-			f.WriteBytes(out, out_len);
-
-			if (cur_len != IN_LEN)
-				break;
-
-			i += cur_len;
-		}
+		CompressAndWriteChunks(f, buffer_data, buffer_size);
 	}
 	else // uncompressed
 	{
@@ -389,27 +459,8 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
 
 		buffer.resize(header.size);
 
-		lzo_uint i = 0;
-		while (true)
-		{
-			lzo_uint32 cur_len = 0;  // number of bytes to read
-			lzo_uint new_len = 0;  // number of bytes to write
-
-			if (!f.ReadArray(&cur_len, 1))
-				break;
-
-			f.ReadBytes(out, cur_len);
-			const int res = lzo1x_decompress(out, cur_len, &buffer[i], &new_len, nullptr);
-			if (res != LZO_E_OK)
-			{
-				// This doesn't seem to happen anymore.
-				PanicAlertT("Internal LZO Error - decompression failed (%d) (%li, %li) \n"
-					"Try loading the state again", res, i, new_len);
-				return;
-			}
-
-			i += new_len;
-		}
+		if (!ReadAndDecompressChunks(f, buffer))
+			return;
 	}
 	else // uncompressed
 	{
@@ -2,8 +2,11 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <mutex>
+
 #include "Common/CommonFuncs.h"
 #include "Core/VolumeHandler.h"
+#include "Core/HW/DVDInterface.h"
 #include "DiscIO/VolumeCreator.h"
 
 namespace VolumeHandler
@@ -11,13 +14,20 @@ namespace VolumeHandler
 
 static DiscIO::IVolume* g_pVolume = nullptr;
 
+// The DVD thread reads from the volume while the CPU thread emulates,
+// and volumes can only be used by one thread at a time.
+static std::mutex s_volume_lock;
+
 DiscIO::IVolume *GetVolume()
 {
+	// The caller uses the volume without holding the lock
+	DVDInterface::WaitForAsyncRead();
 	return g_pVolume;
 }
 
 void EjectVolume()
 {
+	std::lock_guard<std::mutex> lk(s_volume_lock);
 	if (g_pVolume)
 	{
 		// This code looks scary. Can the try/catch stuff be removed?
@@ -31,6 +41,7 @@ void EjectVolume()
 
 bool SetVolumeName(const std::string& _rFullPath)
 {
+	std::lock_guard<std::mutex> lk(s_volume_lock);
 	if (g_pVolume)
 	{
 		delete g_pVolume;
@@ -44,6 +55,7 @@ bool SetVolumeName(const std::string& _rFullPath)
 
 void SetVolumeDirectory(const std::string& _rFullPath, bool _bIsWii, const std::string& _rApploader, const std::string& _rDOL)
 {
+	std::lock_guard<std::mutex> lk(s_volume_lock);
 	if (g_pVolume)
 	{
 		delete g_pVolume;
@@ -55,6 +67,7 @@ void SetVolumeDirectory(const std::string& _rFullPath, bool _bIsWii, const std::
 
 u32 Read32(u64 _Offset, bool decrypt)
 {
+	std::lock_guard<std::mutex> lk(s_volume_lock);
 	if (g_pVolume != nullptr)
 	{
 		u32 Temp;
@@ -66,6 +79,7 @@ u32 Read32(u64 _Offset, bool decrypt)
 
 bool ReadToPtr(u8* ptr, u64 _dwOffset, u64 _dwLength, bool decrypt)
 {
+	std::lock_guard<std::mutex> lk(s_volume_lock);
 	if (g_pVolume != nullptr && ptr)
 		return g_pVolume->Read(_dwOffset, _dwLength, ptr, decrypt);
 
@@ -74,11 +88,13 @@ bool ReadToPtr(u8* ptr, u64 _dwOffset, u64 _dwLength, bool decrypt)
 
 bool IsValid()
 {
+	std::lock_guard<std::mutex> lk(s_volume_lock);
 	return (g_pVolume != nullptr);
 }
 
 bool IsWiiDisc()
 {
+	std::lock_guard<std::mutex> lk(s_volume_lock);
 	if (g_pVolume)
 		return g_pVolume->IsWiiDisc();
 
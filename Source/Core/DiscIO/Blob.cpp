@@ -2,13 +2,17 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstddef>
 #include <cstring>
+#include <iterator>
 #include <string>
 
 #include "Common/CDUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/Thread.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/CISOBlob.h"
@@ -25,35 +29,253 @@ namespace DiscIO
 
 void SectorReader::SetSectorSize(int blocksize)
 {
-	for (int i = 0; i < CACHE_SIZE; i++)
+	m_cache.clear();
+	m_cache_index.clear();
+	m_blocksize = blocksize;
+}
+
+void SectorReader::SetCacheSize(size_t num_blocks)
+{
+	m_cache_size = std::max<size_t>(num_blocks, 1);
+	while (m_cache.size() > m_cache_size)
 	{
-		m_cache[i] = new u8[blocksize];
-		m_cache_tags[i] = (u64)(s64) - 1;
+		m_cache_index.erase(m_cache.back().block);
+		m_cache.pop_back();
 	}
-	m_blocksize = blocksize;
 }
 
 SectorReader::~SectorReader()
 {
-	for (u8*& block : m_cache)
+	StopReadAhead();
+
+	INFO_LOG(DISCIO, "Block cache: %" PRIu64 " hits, %" PRIu64 " read ahead, %" PRIu64 " misses",
+	         m_stats.hits, m_stats.read_ahead_hits, m_stats.misses);
+}
+
+void SectorReader::EnableReadAhead(int num_blocks)
+{
+	StopReadAhead();
+
+	m_read_ahead_blocks = num_blocks;
+	if (num_blocks <= 0)
+		return;
+
+	m_read_ahead_running = true;
+	m_read_ahead_thread = std::thread(&SectorReader::ReadAheadThread, this);
+}
+
+void SectorReader::StopReadAhead()
+{
+	if (!m_read_ahead_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lk(m_read_ahead_mutex);
+		m_read_ahead_running = false;
+		m_read_ahead_queue.clear();
+	}
+	m_read_ahead_cv.notify_one();
+	m_read_ahead_thread.join();
+
+	m_read_ahead_blocks = 0;
+	m_read_ahead_done.clear();
+}
+
+void SectorReader::ReadAheadThread()
+{
+	Common::SetCurrentThreadName("Blob read-ahead");
+
+	std::unique_lock<std::mutex> lk(m_read_ahead_mutex);
+	while (true)
+	{
+		m_read_ahead_cv.wait(lk, [this] { return !m_read_ahead_running || !m_read_ahead_queue.empty(); });
+		if (!m_read_ahead_running)
+			return;
+
+		u64 block_num = m_read_ahead_queue.front();
+		m_read_ahead_queue.pop_front();
+		m_read_ahead_current = block_num;
+		lk.unlock();
+
+		std::vector<u8> data(m_blocksize);
+		{
+			std::lock_guard<std::recursive_mutex> io_lk(m_io_mutex);
+			GetBlock(block_num, data.data());
+		}
+
+		lk.lock();
+		m_read_ahead_done[block_num].swap(data);
+		m_read_ahead_current = (u64)-1;
+		m_read_ahead_done_cv.notify_all();
+	}
+}
+
+// Moves a block which was read ahead into data.
+bool SectorReader::TakeReadAheadBlock(u64 block_num, std::vector<u8>& data)
+{
+	if (m_read_ahead_blocks <= 0)
+		return false;
+
+	std::unique_lock<std::mutex> lk(m_read_ahead_mutex);
+
+	// A block which is being read right now is worth waiting for.
+	m_read_ahead_done_cv.wait(lk, [&] { return m_read_ahead_current != block_num; });
+
+	auto it = m_read_ahead_done.find(block_num);
+	if (it == m_read_ahead_done.end())
+	{
+		// We're going to read it ourselves
+		auto queued = std::find(m_read_ahead_queue.begin(), m_read_ahead_queue.end(), block_num);
+		if (queued != m_read_ahead_queue.end())
+			m_read_ahead_queue.erase(queued);
+		return false;
+	}
+
+	data.swap(it->second);
+	m_read_ahead_done.erase(it);
+	return true;
+}
+
+bool SectorReader::IsBlockAvailable(u64 block_num)
+{
+	if (m_cache_index.count(block_num))
+		return true;
+
+	if (m_read_ahead_blocks <= 0)
+		return false;
+
+	std::lock_guard<std::mutex> lk(m_read_ahead_mutex);
+	return m_read_ahead_done.count(block_num) || m_read_ahead_current == block_num;
+}
+
+// Detects sequential reads and queues the blocks following them.
+void SectorReader::UpdateReadAhead(u64 block_num, u64 num_blocks)
+{
+	// Nothing changes while the same block is read again and again.
+	if (m_read_ahead_blocks <= 0 || (block_num == m_last_block && num_blocks == 1))
+		return;
+
+	if (block_num == m_last_block + 1)
+		m_sequential_reads++;
+	else if (block_num != m_last_block)
+		m_sequential_reads = 0;
+	m_last_block = block_num + num_blocks - 1;
+
+	std::lock_guard<std::mutex> lk(m_read_ahead_mutex);
+	m_read_ahead_queue.clear();
+
+	if (m_sequential_reads < SEQUENTIAL_READS_FOR_READ_AHEAD)
+		return;
+
+	// Forget blocks which were read ahead but have been skipped since
+	const u64 first = m_last_block + 1;
+	const u64 end = std::min<u64>(first + m_read_ahead_blocks, (GetDataSize() + m_blocksize - 1) / m_blocksize);
+	for (auto it = m_read_ahead_done.begin(); it != m_read_ahead_done.end();)
+	{
+		if (it->first < first || it->first >= end)
+			it = m_read_ahead_done.erase(it);
+		else
+			++it;
+	}
+
+	for (u64 i = first; i < end; i++)
+	{
+		if (!m_cache_index.count(i) && !m_read_ahead_done.count(i) && m_read_ahead_current != i)
+			m_read_ahead_queue.push_back(i);
+	}
+
+	if (!m_read_ahead_queue.empty())
+		m_read_ahead_cv.notify_one();
+}
+
+// Returns the cache entry for a block which isn't cached yet, evicting the least recently used one if necessary.
+SectorReader::CacheEntry& SectorReader::InsertBlock(u64 block_num)
+{
+	if (m_cache.size() < m_cache_size)
 	{
-		delete [] block;
+		m_cache.emplace_front();
+		m_cache.front().data.resize(m_blocksize);
 	}
+	else
+	{
+		m_cache.splice(m_cache.begin(), m_cache, std::prev(m_cache.end()));
+		m_cache_index.erase(m_cache.front().block);
+	}
+
+	m_cache.front().block = block_num;
+	m_cache_index[block_num] = m_cache.begin();
+	return m_cache.front();
 }
 
 const u8 *SectorReader::GetBlockData(u64 block_num)
 {
-	// TODO : Expand usage of the cache to more than one block :P
-	if (m_cache_tags[0] == block_num)
+	auto it = m_cache_index.find(block_num);
+	if (it != m_cache_index.end())
 	{
-		return m_cache[0];
+		m_cache.splice(m_cache.begin(), m_cache, it->second);
+		m_stats.hits++;
 	}
 	else
 	{
-		GetBlock(block_num, m_cache[0]);
-		m_cache_tags[0] = block_num;
-		return m_cache[0];
+		CacheEntry& entry = InsertBlock(block_num);
+		if (TakeReadAheadBlock(block_num, entry.data))
+		{
+			m_stats.read_ahead_hits++;
+		}
+		else
+		{
+			std::lock_guard<std::recursive_mutex> lk(m_io_mutex);
+			GetBlock(block_num, entry.data.data());
+			m_stats.misses++;
+		}
+	}
+
+	UpdateReadAhead(block_num, 1);
+	return m_cache.front().data.data();
+}
+
+// Reads whole blocks. Blocks which are cached or have been read ahead are copied,
+// the others are read with as few calls to ReadMultipleAlignedBlocks as possible.
+bool SectorReader::ReadBlocks(u64 block_num, u64 num_blocks, u8 *out_ptr)
+{
+	std::vector<u8> read_ahead_data;
+	u64 i = 0;
+	while (i < num_blocks)
+	{
+		u8* out = out_ptr + i * m_blocksize;
+
+		auto it = m_cache_index.find(block_num + i);
+		if (it != m_cache_index.end())
+		{
+			memcpy(out, it->second->data.data(), m_blocksize);
+			m_stats.hits++;
+			i++;
+			continue;
+		}
+
+		if (TakeReadAheadBlock(block_num + i, read_ahead_data))
+		{
+			memcpy(out, read_ahead_data.data(), m_blocksize);
+			m_stats.read_ahead_hits++;
+			i++;
+			continue;
+		}
+
+		u64 run_end = i + 1;
+		while (run_end < num_blocks && !IsBlockAvailable(block_num + run_end))
+			run_end++;
+
+		{
+			std::lock_guard<std::recursive_mutex> lk(m_io_mutex);
+			if (!ReadMultipleAlignedBlocks(block_num + i, run_end - i, out))
+				return false;
+		}
+		m_stats.misses += run_end - i;
+		i = run_end;
 	}
+
+	UpdateReadAhead(block_num, num_blocks);
+	return true;
 }
 
 bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
@@ -70,7 +292,8 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
 		if (positionInBlock == 0 && remain > (u64)m_blocksize)
 		{
 			u64 num_blocks = remain / m_blocksize;
-			ReadMultipleAlignedBlocks(block, num_blocks, out_ptr);
+			if (!ReadBlocks(block, num_blocks, out_ptr))
+				return false;
 			block += num_blocks;
 			out_ptr += num_blocks * m_blocksize;
 			remain -= num_blocks * m_blocksize;
@@ -108,16 +331,18 @@ bool SectorReader::Read(u64 offset, u64 size, u8* out_ptr)
 bool SectorReader::ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8 *out_ptr)
 {
 	for (u64 i = 0; i < num_blocks; i++)
-	{
-		const u8 *data = GetBlockData(block_num + i);
-		if (!data)
-			return false;
-		memcpy(out_ptr + i * m_blocksize, data, m_blocksize);
-	}
+		GetBlock(block_num + i, out_ptr + i * m_blocksize);
 
 	return true;
 }
 
+static bool s_map_plain_images = false;
+
+void SetMapPlainImages(bool enable)
+{
+	s_map_plain_images = enable;
+}
+
 IBlobReader* CreateBlobReader(const std::string& filename)
 {
 	if (cdio_is_cdrom(filename))
@@ -136,6 +361,11 @@ IBlobReader* CreateBlobReader(const std::string& filename)
 		return CISOFileReader::Create(filename);
 
 	// Still here? Assume plain file - since we know it exists due to the File::Exists check above.
+	if (s_map_plain_images)
+	{
+		if (MappedFileReader* reader = MappedFileReader::Create(filename))
+			return reader;
+	}
 	return PlainFileReader::Create(filename);
 }
 
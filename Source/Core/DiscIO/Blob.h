@@ -14,7 +14,15 @@
 // detect whether the file is a compressed blob, or just a big hunk of data, or a drive, and
 // automatically do the right thing.
 
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 
 namespace DiscIO
@@ -37,11 +45,18 @@ protected:
 
 // Provides caching and split-operation-to-block-operations facilities.
 // Used for compressed blob reading and direct drive reading.
-// Currently only uses a single entry cache.
-// Multi-block reads are not cached.
+// Blocks are kept in an LRU cache. Readers can also enable read-ahead, which reads the
+// blocks following a sequential access pattern on a background thread.
 class SectorReader : public IBlobReader
 {
 public:
+	struct CacheStats
+	{
+		u64 hits;
+		u64 read_ahead_hits;
+		u64 misses;
+	};
+
 	virtual ~SectorReader();
 
 	// A pointer returned by GetBlockData is invalidated as soon as GetBlockData, Read, or ReadMultipleAlignedBlocks is called again.
@@ -49,25 +64,86 @@ public:
 	virtual bool Read(u64 offset, u64 size, u8 *out_ptr) override;
 	friend class DriveReader;
 
+	void SetCacheSize(size_t num_blocks);
+	CacheStats GetCacheStats() const { return m_stats; }
+
 protected:
 	void SetSectorSize(int blocksize);
 	virtual void GetBlock(u64 block_num, u8 *out) = 0;
-	// This one is uncached. The default implementation is to simply call GetBlockData multiple times and memcpy.
+	// This one is uncached. The default implementation is to simply call GetBlock multiple times.
 	virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8 *out_ptr);
 
+	// Once enabled, GetBlock is also called from the read-ahead thread, but never at the same
+	// time as GetBlock or ReadMultipleAlignedBlocks on the reading thread.
+	// Readers which enable it have to stop it in their destructor.
+	void EnableReadAhead(int num_blocks);
+	void StopReadAhead();
+
 private:
-	enum { CACHE_SIZE = 32 };
+	enum
+	{
+		DEFAULT_CACHE_SIZE = 32,
+		// Number of consecutive sequential reads before blocks are read ahead
+		SEQUENTIAL_READS_FOR_READ_AHEAD = 2,
+	};
+
+	struct CacheEntry
+	{
+		u64 block;
+		std::vector<u8> data;
+	};
+
+	CacheEntry& InsertBlock(u64 block_num);
+	bool IsBlockAvailable(u64 block_num);
+	bool ReadBlocks(u64 block_num, u64 num_blocks, u8 *out_ptr);
+	bool TakeReadAheadBlock(u64 block_num, std::vector<u8>& data);
+	void UpdateReadAhead(u64 block_num, u64 num_blocks);
+	void ReadAheadThread();
+
 	int m_blocksize;
-	u8* m_cache[CACHE_SIZE];
-	u64 m_cache_tags[CACHE_SIZE];
-	int m_cache_age[CACHE_SIZE];
+
+	// Most recently used block first
+	std::list<CacheEntry> m_cache;
+	std::unordered_map<u64, std::list<CacheEntry>::iterator> m_cache_index;
+	size_t m_cache_size = DEFAULT_CACHE_SIZE;
+	CacheStats m_stats = {};
+
+	// Serializes GetBlock and ReadMultipleAlignedBlocks between the threads.
+	std::recursive_mutex m_io_mutex;
+
+	int m_read_ahead_blocks = 0;
+	u64 m_last_block = (u64)-1;
+	int m_sequential_reads = 0;
+	std::thread m_read_ahead_thread;
+	std::mutex m_read_ahead_mutex;
+	std::condition_variable m_read_ahead_cv;
+	std::condition_variable m_read_ahead_done_cv;
+	std::deque<u64> m_read_ahead_queue;
+	std::unordered_map<u64, std::vector<u8>> m_read_ahead_done;
+	u64 m_read_ahead_current = (u64)-1;
+	bool m_read_ahead_running = false;
 };
 
 // Factory function - examines the path to choose the right type of IBlobReader, and returns one.
 IBlobReader* CreateBlobReader(const std::string& filename);
 
+// Whether CreateBlobReader maps plain images into memory, see MappedFileReader. Off by default.
+void SetMapPlainImages(bool enable);
+
 typedef bool (*CompressCB)(const std::string& text, float percent, void* arg);
 
+enum BlobFormat
+{
+	BLOB_FORMAT_PLAIN,
+	BLOB_FORMAT_GCZ,
+};
+
+// Converts any image CreateBlobReader can open. The input is read on its own thread, scrubbed
+// (Wii discs only) and compressed on worker threads, and written out in order by the calling thread.
+// block_size only applies to GCZ output.
+bool ConvertBlob(const std::string& infile, const std::string& outfile, BlobFormat format, bool scrub,
+		int block_size = 16384, CompressCB callback = nullptr, void *arg = nullptr);
+
 bool CompressFileToBlob(const std::string& infile, const std::string& outfile, u32 sub_type = 0, int sector_size = 16384,
 		CompressCB callback = nullptr, void *arg = nullptr);
 bool DecompressBlobToFile(const std::string& infile, const std::string& outfile,
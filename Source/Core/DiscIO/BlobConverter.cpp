@@ -0,0 +1,399 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/CompressedBlob.h"
+#include "DiscIO/DiscScrubber.h"
+
+namespace DiscIO
+{
+
+// Plain images are written in larger pieces, which also lets a GCZ input decompress them on several threads.
+static const int PLAIN_BLOCK_SIZE = 0x200000;
+
+namespace
+{
+
+// A block which is on its way from the input to the output file
+struct CompressionSlot
+{
+	enum State
+	{
+		FREE,
+		READ,
+		DONE,
+	};
+
+	std::vector<u8> in_buf;
+	std::vector<u8> out_buf;
+	u64 offset;
+	u32 size;
+	int comp_size;
+	bool stored;
+	u32 hash;
+	State state;
+};
+
+// Compresses the blocks of a blob on worker threads while the calling thread writes the compressed
+// blocks out in order. A reader thread reads the input ahead into a ring of slots, and the workers
+// also scrub the blocks. For plain output the blocks are only scrubbed.
+class BlockCompressor
+{
+public:
+	BlockCompressor(IBlobReader* reader, BlobFormat format, bool scrub, u32 block_size)
+		: m_reader(reader), m_format(format), m_scrub(scrub), m_block_size(block_size)
+	{
+		m_num_blocks = (u32)((reader->GetDataSize() + (block_size - 1)) / block_size);
+
+		int num_threads = std::min<int>(cpu_info.num_cores - 1, MAX_COMPRESSION_THREADS);
+		m_slots.resize(std::max(num_threads, 1) * SLOTS_PER_THREAD);
+		for (CompressionSlot& slot : m_slots)
+		{
+			slot.in_buf.resize(block_size);
+			if (format == BLOB_FORMAT_GCZ)
+				slot.out_buf.resize(block_size);
+			slot.state = CompressionSlot::FREE;
+		}
+
+		// Without worker threads the reader thread processes the blocks itself.
+		if (num_threads <= 0)
+			InitWorker(&m_stream);
+
+		for (int i = 0; i < num_threads; i++)
+			m_threads.emplace_back(&BlockCompressor::WorkerThread, this);
+		m_reader_thread = std::thread(&BlockCompressor::ReaderThread, this);
+	}
+
+	~BlockCompressor()
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			m_running = false;
+		}
+		m_cv.notify_all();
+		m_free_cv.notify_all();
+
+		m_reader_thread.join();
+		for (std::thread& thread : m_threads)
+			thread.join();
+
+		if (m_threads.empty())
+			ShutdownWorker(&m_stream);
+	}
+
+	u32 GetNumBlocks() const { return m_num_blocks; }
+
+	// Waits until the given block has been processed. Returns nullptr if it couldn't be read.
+	const CompressionSlot* Wait(u32 block)
+	{
+		CompressionSlot& slot = m_slots[block % m_slots.size()];
+		std::unique_lock<std::mutex> lk(m_mutex);
+		m_done_cv.wait(lk, [&] { return slot.state == CompressionSlot::DONE || m_read_error; });
+		return slot.state == CompressionSlot::DONE ? &slot : nullptr;
+	}
+
+	// Hands the slot of a block which has been written out back to the reader thread.
+	void ReleaseBlock(u32 block)
+	{
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			m_slots[block % m_slots.size()].state = CompressionSlot::FREE;
+		}
+		m_free_cv.notify_one();
+	}
+
+private:
+	enum
+	{
+		MAX_COMPRESSION_THREADS = 16,
+		SLOTS_PER_THREAD = 4,
+	};
+
+	void InitWorker(z_stream* z)
+	{
+		if (m_format == BLOB_FORMAT_GCZ && deflateInit(z, 9) != Z_OK)
+			ERROR_LOG(DISCIO, "Deflate failed");
+	}
+
+	void ShutdownWorker(z_stream* z)
+	{
+		if (m_format == BLOB_FORMAT_GCZ)
+			deflateEnd(z);
+	}
+
+	void Compress(z_stream* z, CompressionSlot& slot)
+	{
+		if (m_scrub)
+			DiscScrubber::ScrubBlock(slot.offset, slot.in_buf.data(), slot.size);
+
+		if (m_format != BLOB_FORMAT_GCZ)
+			return;
+
+		deflateReset(z);
+		z->next_in   = slot.in_buf.data();
+		z->avail_in  = m_block_size;
+		z->next_out  = slot.out_buf.data();
+		z->avail_out = m_block_size;
+
+		int status = deflate(z, Z_FINISH);
+		slot.comp_size = m_block_size - z->avail_out;
+		if ((status != Z_STREAM_END) || (z->avail_out < 10))
+		{
+			// let's store uncompressed
+			slot.stored = true;
+			slot.hash = HashAdler32(slot.in_buf.data(), m_block_size);
+		}
+		else
+		{
+			slot.stored = false;
+			slot.hash = HashAdler32(slot.out_buf.data(), slot.comp_size);
+		}
+	}
+
+	void ReaderThread()
+	{
+		Common::SetCurrentThreadName("Blob reader");
+
+		const u64 data_size = m_reader->GetDataSize();
+		for (u32 block = 0; block < m_num_blocks; block++)
+		{
+			CompressionSlot& slot = m_slots[block % m_slots.size()];
+			{
+				std::unique_lock<std::mutex> lk(m_mutex);
+				m_free_cv.wait(lk, [&] { return !m_running || slot.state == CompressionSlot::FREE; });
+				if (!m_running)
+					return;
+			}
+
+			slot.offset = (u64)block * m_block_size;
+			slot.size = (u32)std::min<u64>(m_block_size, data_size - slot.offset);
+			if (!m_reader->Read(slot.offset, slot.size, slot.in_buf.data()))
+			{
+				ERROR_LOG(DISCIO, "Failed to read block %u of the input", block);
+				std::lock_guard<std::mutex> lk(m_mutex);
+				m_read_error = true;
+				m_done_cv.notify_all();
+				return;
+			}
+			std::fill(slot.in_buf.begin() + slot.size, slot.in_buf.end(), 0);
+
+			if (m_threads.empty())
+			{
+				Compress(&m_stream, slot);
+				std::lock_guard<std::mutex> lk(m_mutex);
+				slot.state = CompressionSlot::DONE;
+				m_done_cv.notify_all();
+				continue;
+			}
+
+			{
+				std::lock_guard<std::mutex> lk(m_mutex);
+				slot.state = CompressionSlot::READ;
+				m_queue.push_back(&slot);
+			}
+			m_cv.notify_one();
+		}
+	}
+
+	void WorkerThread()
+	{
+		Common::SetCurrentThreadName("Blob compressor");
+
+		z_stream z = {};
+		InitWorker(&z);
+
+		while (true)
+		{
+			CompressionSlot* slot;
+			{
+				std::unique_lock<std::mutex> lk(m_mutex);
+				m_cv.wait(lk, [&] { return !m_running || !m_queue.empty(); });
+				if (!m_running)
+					break;
+				slot = m_queue.front();
+				m_queue.pop_front();
+			}
+
+			Compress(&z, *slot);
+
+			{
+				std::lock_guard<std::mutex> lk(m_mutex);
+				slot->state = CompressionSlot::DONE;
+			}
+			m_done_cv.notify_all();
+		}
+
+		ShutdownWorker(&z);
+	}
+
+	IBlobReader* m_reader;
+	BlobFormat m_format;
+	bool m_scrub;
+	u32 m_block_size;
+	u32 m_num_blocks;
+	std::vector<CompressionSlot> m_slots;
+	z_stream m_stream = {};
+
+	std::thread m_reader_thread;
+	std::vector<std::thread> m_threads;
+	std::deque<CompressionSlot*> m_queue;
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::condition_variable m_done_cv;
+	std::condition_variable m_free_cv;
+	bool m_running = true;
+	bool m_read_error = false;
+};
+
+}  // namespace
+
+bool ConvertBlob(const std::string& infile, const std::string& outfile, BlobFormat format, bool scrub,
+                 int block_size, CompressCB callback, void* arg)
+{
+	if (format == BLOB_FORMAT_PLAIN)
+		block_size = PLAIN_BLOCK_SIZE;
+
+	if (scrub && !DiscScrubber::SetupScrub(infile))
+	{
+		PanicAlertT("%s failed to be scrubbed. Probably the image is corrupt.", infile.c_str());
+		return false;
+	}
+
+	std::unique_ptr<IBlobReader> reader(CreateBlobReader(infile));
+	File::IOFile f(outfile, "wb");
+
+	if (!f || !reader)
+	{
+		DiscScrubber::Cleanup();
+		return false;
+	}
+
+	if (callback && format == BLOB_FORMAT_GCZ)
+		callback("Files opened, ready to compress.", 0, arg);
+
+	bool success = true;
+	bool was_cancelled = false;
+	{
+		BlockCompressor compressor(reader.get(), format, scrub, block_size);
+
+		CompressedBlobHeader header;
+		header.magic_cookie = kBlobCookie;
+		header.sub_type   = scrub ? 1 : 0;
+		header.block_size = block_size;
+		header.data_size  = reader->GetDataSize();
+		header.num_blocks = compressor.GetNumBlocks();
+
+		std::vector<u64> offsets;
+		std::vector<u32> hashes;
+		if (format == BLOB_FORMAT_GCZ)
+		{
+			offsets.resize(header.num_blocks);
+			hashes.resize(header.num_blocks);
+
+			// seek past the header and the offset and hash tables (we will write them at the end)
+			f.Seek(sizeof(CompressedBlobHeader) + (sizeof(u64) + sizeof(u32)) * header.num_blocks, SEEK_SET);
+		}
+
+		u64 position = 0;
+		int progress_monitor = std::max<int>(1, header.num_blocks / 1000);
+
+		for (u32 i = 0; i < header.num_blocks; i++)
+		{
+			if (callback && i % progress_monitor == 0)
+			{
+				std::string temp;
+				if (format == BLOB_FORMAT_GCZ)
+				{
+					const u64 inpos = (u64)i * block_size;
+					int ratio = 0;
+					if (inpos != 0)
+						ratio = (int)(100 * position / inpos);
+					temp = StringFromFormat("%i of %i blocks. Compression ratio %i%%", i, header.num_blocks, ratio);
+				}
+				else
+				{
+					temp = StringFromFormat("%i of %i blocks", i, header.num_blocks);
+				}
+
+				was_cancelled = !callback(temp, (float)i / (float)header.num_blocks, arg);
+				if (was_cancelled)
+					break;
+			}
+
+			const CompressionSlot* slot = compressor.Wait(i);
+			if (!slot)
+			{
+				success = false;
+				break;
+			}
+
+			if (format == BLOB_FORMAT_PLAIN)
+			{
+				success = f.WriteBytes(slot->in_buf.data(), slot->size);
+				position += slot->size;
+			}
+			else if (slot->stored)
+			{
+				// let's store uncompressed
+				offsets[i] = position | 0x8000000000000000ULL;
+				hashes[i] = slot->hash;
+				success = f.WriteBytes(slot->in_buf.data(), block_size);
+				position += block_size;
+			}
+			else
+			{
+				// let's store compressed
+				offsets[i] = position;
+				hashes[i] = slot->hash;
+				success = f.WriteBytes(slot->out_buf.data(), slot->comp_size);
+				position += slot->comp_size;
+			}
+			compressor.ReleaseBlock(i);
+
+			if (!success)
+				break;
+		}
+
+		if (success && !was_cancelled && format == BLOB_FORMAT_GCZ)
+		{
+			// Okay, go back and fill in headers
+			header.compressed_data_size = position;
+			f.Seek(0, SEEK_SET);
+			f.WriteArray(&header, 1);
+			f.WriteArray(offsets.data(), header.num_blocks);
+			f.WriteArray(hashes.data(), header.num_blocks);
+		}
+	}
+
+	if (!success || was_cancelled)
+	{
+		// Remove the incomplete output file.
+		f.Close();
+		File::Delete(outfile);
+	}
+
+	DiscScrubber::Cleanup();
+	if (callback && format == BLOB_FORMAT_GCZ)
+		callback("Done compressing disc image.", 1.0f, arg);
+	return success;
+}
+
+}  // namespace
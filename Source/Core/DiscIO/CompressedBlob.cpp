@@ -17,12 +17,11 @@
 #include <zlib.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
 #include "Common/FileUtil.h"
 #include "Common/Hash.h"
-#include "Common/StringUtil.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/CompressedBlob.h"
-#include "DiscIO/DiscScrubber.h"
 
 
 namespace DiscIO
@@ -51,6 +50,8 @@ CompressedBlobReader::CompressedBlobReader(const std::string& filename) : m_file
 	m_zlib_buffer_size = m_header.block_size + 64;
 	m_zlib_buffer = new u8[m_zlib_buffer_size];
 	memset(m_zlib_buffer, 0, m_zlib_buffer_size);
+
+	EnableReadAhead(READ_AHEAD_BLOCKS);
 }
 
 CompressedBlobReader* CompressedBlobReader::Create(const std::string& filename)
@@ -63,6 +64,7 @@ CompressedBlobReader* CompressedBlobReader::Create(const std::string& filename)
 
 CompressedBlobReader::~CompressedBlobReader()
 {
+	StopReadAhead();
 	delete [] m_zlib_buffer;
 	delete [] m_block_pointers;
 	delete [] m_hashes;
@@ -81,29 +83,9 @@ u64 CompressedBlobReader::GetBlockCompressedSize(u64 block_num) const
 	return 0;
 }
 
-void CompressedBlobReader::GetBlock(u64 block_num, u8 *out_ptr)
+// Doesn't touch any member buffers, so several blocks can be decompressed at the same time.
+void CompressedBlobReader::DecompressBlock(u64 block_num, const u8* source, u32 comp_block_size, bool uncompressed, u8* dest) const
 {
-	bool uncompressed = false;
-	u32 comp_block_size = (u32)GetBlockCompressedSize(block_num);
-	u64 offset = m_block_pointers[block_num] + m_data_offset;
-
-	if (offset & (1ULL << 63))
-	{
-		if (comp_block_size != m_header.block_size)
-			PanicAlert("Uncompressed block with wrong size");
-		uncompressed = true;
-		offset &= ~(1ULL << 63);
-	}
-
-	// clear unused part of zlib buffer. maybe this can be deleted when it works fully.
-	memset(m_zlib_buffer + comp_block_size, 0, m_zlib_buffer_size - comp_block_size);
-
-	m_file.Seek(offset, SEEK_SET);
-	m_file.ReadBytes(m_zlib_buffer, comp_block_size);
-
-	u8* source = m_zlib_buffer;
-	u8* dest = out_ptr;
-
 	// First, check hash.
 	u32 block_hash = HashAdler32(source, comp_block_size);
 	if (block_hash != m_hashes[block_num])
@@ -120,7 +102,7 @@ void CompressedBlobReader::GetBlock(u64 block_num, u8 *out_ptr)
 	{
 		z_stream z;
 		memset(&z, 0, sizeof(z));
-		z.next_in  = source;
+		z.next_in  = const_cast<u8*>(source);
 		z.avail_in = comp_block_size;
 		if (z.avail_in > m_header.block_size)
 		{
@@ -143,158 +125,78 @@ void CompressedBlobReader::GetBlock(u64 block_num, u8 *out_ptr)
 	}
 }
 
-bool CompressFileToBlob(const std::string& infile, const std::string& outfile, u32 sub_type,
-						int block_size, CompressCB callback, void* arg)
+void CompressedBlobReader::GetBlock(u64 block_num, u8 *out_ptr)
 {
-	bool scrubbing = false;
+	bool uncompressed = false;
+	u32 comp_block_size = (u32)GetBlockCompressedSize(block_num);
+	u64 offset = m_block_pointers[block_num] + m_data_offset;
 
-	if (IsCompressedBlob(infile))
+	if (offset & (1ULL << 63))
 	{
-		PanicAlertT("%s is already compressed! Cannot compress it further.", infile.c_str());
-		return false;
+		if (comp_block_size != m_header.block_size)
+			PanicAlert("Uncompressed block with wrong size");
+		uncompressed = true;
+		offset &= ~(1ULL << 63);
 	}
 
-	if (sub_type == 1)
-	{
-		if (!DiscScrubber::SetupScrub(infile, block_size))
-		{
-			PanicAlertT("%s failed to be scrubbed. Probably the image is corrupt.", infile.c_str());
-			return false;
-		}
-
-		scrubbing = true;
-	}
+	// clear unused part of zlib buffer. maybe this can be deleted when it works fully.
+	memset(m_zlib_buffer + comp_block_size, 0, m_zlib_buffer_size - comp_block_size);
 
-	z_stream z = {};
-	if (deflateInit(&z, 9) != Z_OK)
-		return false;
+	m_file.Seek(offset, SEEK_SET);
+	m_file.ReadBytes(m_zlib_buffer, comp_block_size);
 
-	File::IOFile inf(infile, "rb");
-	File::IOFile f(outfile, "wb");
+	DecompressBlock(block_num, m_zlib_buffer, comp_block_size, uncompressed, out_ptr);
+}
 
-	if (!f || !inf)
-	{
-		deflateEnd(&z);
+bool CompressedBlobReader::ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr)
+{
+	int num_threads = std::min<int>(cpu_info.num_cores, (int)(num_blocks / MIN_BLOCKS_PER_THREAD));
+	if (num_threads <= 1 || block_num + num_blocks > m_header.num_blocks)
+		return SectorReader::ReadMultipleAlignedBlocks(block_num, num_blocks, out_ptr);
+
+	// The blocks are stored in order, so the compressed data of all of them can be read at once.
+	const u64 first = m_block_pointers[block_num] & ~(1ULL << 63);
+	const u64 last = block_num + num_blocks < m_header.num_blocks ?
+		m_block_pointers[block_num + num_blocks] & ~(1ULL << 63) : m_header.compressed_data_size;
+	std::vector<u8> compressed(last - first);
+
+	m_file.Seek(m_data_offset + first, SEEK_SET);
+	if (!m_file.ReadBytes(compressed.data(), compressed.size()))
 		return false;
-	}
-
-	callback("Files opened, ready to compress.", 0, arg);
 
-	CompressedBlobHeader header;
-	header.magic_cookie = kBlobCookie;
-	header.sub_type   = sub_type;
-	header.block_size = block_size;
-	header.data_size  = File::GetSize(infile);
-
-	// round upwards!
-	header.num_blocks = (u32)((header.data_size + (block_size - 1)) / block_size);
-
-	u64* offsets = new u64[header.num_blocks];
-	u32* hashes = new u32[header.num_blocks];
-	u8* out_buf = new u8[block_size];
-	u8* in_buf = new u8[block_size];
-
-	// seek past the header (we will write it at the end)
-	f.Seek(sizeof(CompressedBlobHeader), SEEK_CUR);
-	// seek past the offset and hash tables (we will write them at the end)
-	f.Seek((sizeof(u64) + sizeof(u32)) * header.num_blocks, SEEK_CUR);
-
-	// Now we are ready to write compressed data!
-	u64 position = 0;
-	int num_compressed = 0;
-	int num_stored = 0;
-	int progress_monitor = std::max<int>(1, header.num_blocks / 1000);
-	bool was_cancelled = false;
-
-	for (u32 i = 0; i < header.num_blocks; i++)
+	auto decompress = [&](u64 begin, u64 end)
 	{
-		if (i % progress_monitor == 0)
+		for (u64 i = begin; i < end; i++)
 		{
-			const u64 inpos = inf.Tell();
-			int ratio = 0;
-			if (inpos != 0)
-				ratio = (int)(100 * position / inpos);
-
-			std::string temp = StringFromFormat("%i of %i blocks. Compression ratio %i%%", i, header.num_blocks, ratio);
-			was_cancelled = !callback(temp, (float)i / (float)header.num_blocks, arg);
-			if (was_cancelled)
-				break;
+			u64 pointer = m_block_pointers[block_num + i];
+			bool uncompressed = (pointer & (1ULL << 63)) != 0;
+			u64 start = (pointer & ~(1ULL << 63)) - first;
+			u64 next = i + 1 < num_blocks ? (m_block_pointers[block_num + i + 1] & ~(1ULL << 63)) - first : compressed.size();
+			DecompressBlock(block_num + i, &compressed[start], (u32)(next - start), uncompressed, out_ptr + i * m_header.block_size);
 		}
+	};
 
-		offsets[i] = position;
-
-		size_t read_bytes;
-		if (scrubbing)
-			read_bytes = DiscScrubber::GetNextBlock(inf, in_buf);
-		else
-			inf.ReadArray(in_buf, header.block_size, &read_bytes);
-		if (read_bytes < header.block_size)
-			std::fill(in_buf + read_bytes, in_buf + header.block_size, 0);
-
-		int retval = deflateReset(&z);
-		z.next_in   = in_buf;
-		z.avail_in  = header.block_size;
-		z.next_out  = out_buf;
-		z.avail_out = block_size;
+	// Every thread takes an adjacent range of blocks, the calling thread takes the first one.
+	std::vector<std::thread> threads;
+	for (int t = 1; t < num_threads; t++)
+		threads.emplace_back(decompress, num_blocks * t / num_threads, num_blocks * (t + 1) / num_threads);
+	decompress(0, num_blocks / num_threads);
+	for (std::thread& thread : threads)
+		thread.join();
 
-		if (retval != Z_OK)
-		{
-			ERROR_LOG(DISCIO, "Deflate failed");
-			goto cleanup;
-		}
-
-		int status = deflate(&z, Z_FINISH);
-		int comp_size = block_size - z.avail_out;
-		if ((status != Z_STREAM_END) || (z.avail_out < 10))
-		{
-			//PanicAlert("%i %i Store %i", i*block_size, position, comp_size);
-			// let's store uncompressed
-			offsets[i] |= 0x8000000000000000ULL;
-			f.WriteBytes(in_buf, block_size);
-			hashes[i] = HashAdler32(in_buf, block_size);
-			position += block_size;
-			num_stored++;
-		}
-		else
-		{
-			// let's store compressed
-			//PanicAlert("Comp %i to %i", block_size, comp_size);
-			f.WriteBytes(out_buf, comp_size);
-			hashes[i] = HashAdler32(out_buf, comp_size);
-			position += comp_size;
-			num_compressed++;
-		}
-	}
-
-	header.compressed_data_size = position;
+	return true;
+}
 
-	if (was_cancelled)
-	{
-		// Remove the incomplete output file.
-		f.Close();
-		File::Delete(outfile);
-	}
-	else
+bool CompressFileToBlob(const std::string& infile, const std::string& outfile, u32 sub_type,
+						int block_size, CompressCB callback, void* arg)
+{
+	if (IsCompressedBlob(infile))
 	{
-		// Okay, go back and fill in headers
-		f.Seek(0, SEEK_SET);
-		f.WriteArray(&header, 1);
-		f.WriteArray(offsets, header.num_blocks);
-		f.WriteArray(hashes, header.num_blocks);
+		PanicAlertT("%s is already compressed! Cannot compress it further.", infile.c_str());
+		return false;
 	}
 
-cleanup:
-	// Cleanup
-	delete[] in_buf;
-	delete[] out_buf;
-	delete[] offsets;
-	delete[] hashes;
-
-	deflateEnd(&z);
-
-	DiscScrubber::Cleanup();
-	callback("Done compressing disc image.", 1.0f, arg);
-	return true;
+	return ConvertBlob(infile, outfile, BLOB_FORMAT_GCZ, sub_type == 1, block_size, callback, arg);
 }
 
 bool DecompressBlobToFile(const std::string& infile, const std::string& outfile, CompressCB callback, void* arg)
@@ -305,48 +207,7 @@ bool DecompressBlobToFile(const std::string& infile, const std::string& outfile,
 		return false;
 	}
 
-	std::unique_ptr<CompressedBlobReader> reader(CompressedBlobReader::Create(infile));
-	if (!reader)
-		return false;
-
-	File::IOFile f(outfile, "wb");
-	if (!f)
-		return false;
-
-	const CompressedBlobHeader &header = reader->GetHeader();
-	static const size_t BUFFER_BLOCKS = 32;
-	size_t buffer_size = header.block_size * BUFFER_BLOCKS;
-	size_t last_buffer_size = header.block_size * (header.num_blocks % BUFFER_BLOCKS);
-	std::vector<u8> buffer(buffer_size);
-	u32 num_buffers = (header.num_blocks + BUFFER_BLOCKS - 1) / BUFFER_BLOCKS;
-	int progress_monitor = std::max<int>(1, num_buffers / 100);
-	bool was_cancelled = false;
-
-	for (u64 i = 0; i < num_buffers; i++)
-	{
-		if (i % progress_monitor == 0)
-		{
-			was_cancelled = !callback("Unpacking", (float)i / (float)num_buffers, arg);
-			if (was_cancelled)
-				break;
-		}
-		const size_t sz = i == num_buffers - 1 ? last_buffer_size : buffer_size;
-		reader->Read(i * buffer_size, sz, buffer.data());
-		f.WriteBytes(buffer.data(), sz);
-	}
-
-	if (was_cancelled)
-	{
-		// Remove the incomplete output file.
-		f.Close();
-		File::Delete(outfile);
-	}
-	else
-	{
-		f.Resize(header.data_size);
-	}
-
-	return true;
+	return ConvertBlob(infile, outfile, BLOB_FORMAT_PLAIN, false, 0, callback, arg);
 }
 
 bool IsCompressedBlob(const std::string& filename)
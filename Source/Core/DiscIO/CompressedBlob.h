@@ -53,8 +53,20 @@ public:
 	u64 GetRawSize() const override { return m_file_size; }
 	u64 GetBlockCompressedSize(u64 block_num) const;
 	void GetBlock(u64 block_num, u8* out_ptr) override;
+
+protected:
+	// Large sequential reads decompress adjacent blocks on several threads.
+	bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr) override;
+
 private:
+	enum
+	{
+		MIN_BLOCKS_PER_THREAD = 4,
+		READ_AHEAD_BLOCKS = 16,
+	};
+
 	CompressedBlobReader(const std::string& filename);
+	void DecompressBlock(u64 block_num, const u8* source, u32 comp_block_size, bool uncompressed, u8* dest) const;
 
 	CompressedBlobHeader m_header;
 	u64* m_block_pointers;
@@ -27,9 +27,6 @@ namespace DiscScrubber
 
 static u8* m_FreeTable = nullptr;
 static u64 m_FileSize;
-static u64 m_BlockCount;
-static u32 m_BlockSize;
-static int m_BlocksPerCluster;
 static bool m_isScrubbing = false;
 
 static std::string m_Filename;
@@ -73,28 +70,20 @@ static SPartitionGroup PartitionGroup[4];
 
 void MarkAsUsed(u64 _Offset, u64 _Size);
 void MarkAsUsedE(u64 _PartitionDataOffset, u64 _Offset, u64 _Size);
-void ReadFromVolume(u64 _Offset, u64 _Length, u32& _Buffer, bool _Decrypt);
-void ReadFromVolume(u64 _Offset, u64 _Length, u64& _Buffer, bool _Decrypt);
+bool ReadFromVolume(u64 _Offset, std::vector<u8>& _Buffer, bool _Decrypt);
 bool ParseDisc();
 bool ParsePartitionData(SPartition& _rPartition);
 u32 GetDOLSize(u64 _DOLOffset);
 
 
-bool SetupScrub(const std::string& filename, int block_size)
+bool SetupScrub(const std::string& filename)
 {
 	bool success = true;
 	m_Filename = filename;
-	m_BlockSize = block_size;
-
-	if (CLUSTER_SIZE % m_BlockSize != 0)
-	{
-		ERROR_LOG(DISCIO, "Block size %i is not a factor of 0x8000, scrubbing not possible", m_BlockSize);
-		return false;
-	}
-
-	m_BlocksPerCluster = CLUSTER_SIZE / m_BlockSize;
 
 	m_Disc = CreateVolumeFromFilename(filename);
+	if (!m_Disc)
+		return false;
 	m_FileSize = m_Disc->GetSize();
 
 	u32 numClusters = (u32)(m_FileSize / CLUSTER_SIZE);
@@ -112,7 +101,6 @@ bool SetupScrub(const std::string& filename, int block_size)
 	// Done with it; need it closed for the next part
 	delete m_Disc;
 	m_Disc = nullptr;
-	m_BlockCount = 0;
 
 	// Let's not touch the file if we've failed up to here :p
 	if (!success)
@@ -122,27 +110,24 @@ bool SetupScrub(const std::string& filename, int block_size)
 	return success;
 }
 
-size_t GetNextBlock(File::IOFile& in, u8* buffer)
+void ScrubBlock(u64 offset, u8* buffer, size_t size)
 {
-	u64 CurrentOffset = m_BlockCount * m_BlockSize;
-	u64 i = CurrentOffset / CLUSTER_SIZE;
+	if (!m_isScrubbing)
+		return;
 
-	size_t ReadBytes = 0;
-	if (m_isScrubbing && m_FreeTable[i])
+	// The block doesn't have to be aligned to clusters, so check every cluster it touches
+	const u64 end = offset + size;
+	for (u64 cluster_start = offset - offset % CLUSTER_SIZE; cluster_start < end; cluster_start += CLUSTER_SIZE)
 	{
-		DEBUG_LOG(DISCIO, "Freeing 0x%016" PRIx64, CurrentOffset);
-		std::fill(buffer, buffer + m_BlockSize, 0xFF);
-		in.Seek(m_BlockSize, SEEK_CUR);
-		ReadBytes = m_BlockSize;
+		u64 i = cluster_start / CLUSTER_SIZE;
+		if (i >= m_FileSize / CLUSTER_SIZE || !m_FreeTable[i])
+			continue;
+
+		const u64 start = std::max(offset, cluster_start);
+		const u64 stop = std::min(end, cluster_start + CLUSTER_SIZE);
+		DEBUG_LOG(DISCIO, "Freeing 0x%016" PRIx64, start);
+		std::fill(buffer + (start - offset), buffer + (stop - offset), 0xFF);
 	}
-	else
-	{
-		DEBUG_LOG(DISCIO, "Used    0x%016" PRIx64, CurrentOffset);
-		in.ReadArray(buffer, m_BlockSize, &ReadBytes);
-	}
-
-	m_BlockCount++;
-	return ReadBytes;
 }
 
 void Cleanup()
@@ -150,10 +135,9 @@ void Cleanup()
 	if (m_FreeTable) delete[] m_FreeTable;
 	m_FreeTable = nullptr;
 	m_FileSize = 0;
-	m_BlockCount = 0;
-	m_BlockSize = 0;
-	m_BlocksPerCluster = 0;
 	m_isScrubbing = false;
+	for (SPartitionGroup& group : PartitionGroup)
+		group.PartitionsVec.clear();
 }
 
 void MarkAsUsed(u64 _Offset, u64 _Size)
@@ -188,17 +172,10 @@ void MarkAsUsedE(u64 _PartitionDataOffset, u64 _Offset, u64 _Size)
 	MarkAsUsed(Offset, Size);
 }
 
-// Helper functions for reading the BE volume
-void ReadFromVolume(u64 _Offset, u64 _Length, u32& _Buffer, bool _Decrypt)
-{
-	m_Disc->Read(_Offset, _Length, (u8*)&_Buffer, _Decrypt);
-	_Buffer = Common::swap32(_Buffer);
-}
-void ReadFromVolume(u64 _Offset, u64 _Length, u64& _Buffer, bool _Decrypt)
+// Reads a whole structure at once, the values are picked out of the buffer with Common::swap32
+bool ReadFromVolume(u64 _Offset, std::vector<u8>& _Buffer, bool _Decrypt)
 {
-	m_Disc->Read(_Offset, _Length, (u8*)&_Buffer, _Decrypt);
-	_Buffer = Common::swap32((u32)_Buffer);
-	_Buffer <<= 2;
+	return m_Disc->Read(_Offset, _Buffer.size(), _Buffer.data(), _Decrypt);
 }
 
 bool ParseDisc()
@@ -206,10 +183,18 @@ bool ParseDisc()
 	// Mark the header as used - it's mostly 0s anyways
 	MarkAsUsed(0, 0x50000);
 
+	std::vector<u8> groups(4 * 8);
+	if (!ReadFromVolume(0x40000, groups, false))
+		return false;
+
 	for (int x = 0; x < 4; x++)
 	{
-		ReadFromVolume(0x40000 + (x * 8) + 0, 4, PartitionGroup[x].numPartitions, false);
-		ReadFromVolume(0x40000 + (x * 8) + 4, 4, PartitionGroup[x].PartitionsOffset, false);
+		PartitionGroup[x].numPartitions = Common::swap32(&groups[x * 8 + 0]);
+		PartitionGroup[x].PartitionsOffset = (u64)Common::swap32(&groups[x * 8 + 4]) << 2;
+
+		std::vector<u8> partitions(PartitionGroup[x].numPartitions * 8);
+		if (!partitions.empty() && !ReadFromVolume(PartitionGroup[x].PartitionsOffset, partitions, false))
+			return false;
 
 		// Read all partitions
 		for (u32 i = 0; i < PartitionGroup[x].numPartitions; i++)
@@ -219,16 +204,20 @@ bool ParseDisc()
 			Partition.GroupNumber = x;
 			Partition.Number = i;
 
-			ReadFromVolume(PartitionGroup[x].PartitionsOffset + (i * 8) + 0, 4, Partition.Offset, false);
-			ReadFromVolume(PartitionGroup[x].PartitionsOffset + (i * 8) + 4, 4, Partition.Type, false);
+			Partition.Offset = (u64)Common::swap32(&partitions[i * 8 + 0]) << 2;
+			Partition.Type = Common::swap32(&partitions[i * 8 + 4]);
+
+			std::vector<u8> header(0x2c0 - 0x2a4);
+			if (!ReadFromVolume(Partition.Offset + 0x2a4, header, false))
+				return false;
 
-			ReadFromVolume(Partition.Offset + 0x2a4, 4, Partition.Header.TMDSize, false);
-			ReadFromVolume(Partition.Offset + 0x2a8, 4, Partition.Header.TMDOffset, false);
-			ReadFromVolume(Partition.Offset + 0x2ac, 4, Partition.Header.CertChainSize, false);
-			ReadFromVolume(Partition.Offset + 0x2b0, 4, Partition.Header.CertChainOffset, false);
-			ReadFromVolume(Partition.Offset + 0x2b4, 4, Partition.Header.H3Offset, false);
-			ReadFromVolume(Partition.Offset + 0x2b8, 4, Partition.Header.DataOffset, false);
-			ReadFromVolume(Partition.Offset + 0x2bc, 4, Partition.Header.DataSize, false);
+			Partition.Header.TMDSize = Common::swap32(&header[0x2a4 - 0x2a4]);
+			Partition.Header.TMDOffset = (u64)Common::swap32(&header[0x2a8 - 0x2a4]) << 2;
+			Partition.Header.CertChainSize = Common::swap32(&header[0x2ac - 0x2a4]);
+			Partition.Header.CertChainOffset = (u64)Common::swap32(&header[0x2b0 - 0x2a4]) << 2;
+			Partition.Header.H3Offset = (u64)Common::swap32(&header[0x2b4 - 0x2a4]) << 2;
+			Partition.Header.DataOffset = (u64)Common::swap32(&header[0x2b8 - 0x2a4]) << 2;
+			Partition.Header.DataSize = (u64)Common::swap32(&header[0x2bc - 0x2a4]) << 2;
 
 			PartitionGroup[x].PartitionsVec.push_back(Partition);
 		}
@@ -267,11 +256,19 @@ bool ParsePartitionData(SPartition& _rPartition)
 	m_Disc = CreateVolumeFromFilename(m_Filename, _rPartition.GroupNumber, _rPartition.Number);
 	std::unique_ptr<IFileSystem> filesystem(CreateFileSystem(m_Disc));
 
+	// The DOL and FST pointers (0x420 - 0x42c) and the apploader sizes (0x2454 - 0x245c)
+	std::vector<u8> disc_header(0x2460);
+
 	if (!filesystem)
 	{
 		ERROR_LOG(DISCIO, "Failed to create filesystem for group %d partition %u", _rPartition.GroupNumber, _rPartition.Number);
 		ParsedOK = false;
 	}
+	else if (!ReadFromVolume(0, disc_header, true))
+	{
+		ERROR_LOG(DISCIO, "Failed to read the header of group %d partition %u", _rPartition.GroupNumber, _rPartition.Number);
+		ParsedOK = false;
+	}
 	else
 	{
 		std::vector<const SFileInfo *> Files;
@@ -279,8 +276,8 @@ bool ParsePartitionData(SPartition& _rPartition)
 
 		// Mark things as used which are not in the filesystem
 		// Header, Header Information, Apploader
-		ReadFromVolume(0x2440 + 0x14, 4, _rPartition.Header.ApploaderSize, true);
-		ReadFromVolume(0x2440 + 0x18, 4, _rPartition.Header.ApploaderTrailerSize, true);
+		_rPartition.Header.ApploaderSize = Common::swap32(&disc_header[0x2440 + 0x14]);
+		_rPartition.Header.ApploaderTrailerSize = Common::swap32(&disc_header[0x2440 + 0x18]);
 		MarkAsUsedE(_rPartition.Offset
 			+ _rPartition.Header.DataOffset
 			, 0
@@ -289,7 +286,7 @@ bool ParsePartitionData(SPartition& _rPartition)
 			+ _rPartition.Header.ApploaderTrailerSize);
 
 		// DOL
-		ReadFromVolume(0x420, 4, _rPartition.Header.DOLOffset, true);
+		_rPartition.Header.DOLOffset = (u64)Common::swap32(&disc_header[0x420]) << 2;
 		_rPartition.Header.DOLSize = GetDOLSize(_rPartition.Header.DOLOffset);
 		MarkAsUsedE(_rPartition.Offset
 			+ _rPartition.Header.DataOffset
@@ -297,8 +294,8 @@ bool ParsePartitionData(SPartition& _rPartition)
 			, _rPartition.Header.DOLSize);
 
 		// FST
-		ReadFromVolume(0x424, 4, _rPartition.Header.FSTOffset, true);
-		ReadFromVolume(0x428, 4, _rPartition.Header.FSTSize, true);
+		_rPartition.Header.FSTOffset = (u64)Common::swap32(&disc_header[0x424]) << 2;
+		_rPartition.Header.FSTSize = (u64)Common::swap32(&disc_header[0x428]) << 2;
 		MarkAsUsedE(_rPartition.Offset
 			+ _rPartition.Header.DataOffset
 			, _rPartition.Header.FSTOffset
@@ -329,13 +326,17 @@ bool ParsePartitionData(SPartition& _rPartition)
 
 u32 GetDOLSize(u64 _DOLOffset)
 {
-	u32 offset = 0, size = 0, max = 0;
+	u32 max = 0;
+
+	std::vector<u8> dol_header(0x100);
+	if (!ReadFromVolume(_DOLOffset, dol_header, true))
+		return 0;
 
 	// Iterate through the 7 code segments
 	for (u8 i = 0; i < 7; i++)
 	{
-		ReadFromVolume(_DOLOffset + 0x00 + i * 4, 4, offset, true);
-		ReadFromVolume(_DOLOffset + 0x90 + i * 4, 4, size, true);
+		u32 offset = Common::swap32(&dol_header[0x00 + i * 4]);
+		u32 size = Common::swap32(&dol_header[0x90 + i * 4]);
 		if (offset + size > max)
 			max = offset + size;
 	}
@@ -343,8 +344,8 @@ u32 GetDOLSize(u64 _DOLOffset)
 	// Iterate through the 11 data segments
 	for (u8 i = 0; i < 11; i++)
 	{
-		ReadFromVolume(_DOLOffset + 0x1c + i * 4, 4, offset, true);
-		ReadFromVolume(_DOLOffset + 0xac + i * 4, 4, size, true);
+		u32 offset = Common::swap32(&dol_header[0x1c + i * 4]);
+		u32 size = Common::swap32(&dol_header[0xac + i * 4]);
 		if (offset + size > max)
 			max = offset + size;
 	}
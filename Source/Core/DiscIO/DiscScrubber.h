@@ -13,19 +13,20 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include "Common/CommonTypes.h"
 
-namespace File { class IOFile; }
-
 namespace DiscIO
 {
 
 namespace DiscScrubber
 {
 
-bool SetupScrub(const std::string& filename, int block_size);
-size_t GetNextBlock(File::IOFile& in, u8* buffer);
+bool SetupScrub(const std::string& filename);
+// Fills the unused parts of a block of the disc with 0xFF. Only reads the table of used
+// clusters, so it can be called from several threads at once.
+void ScrubBlock(u64 offset, u8* buffer, size_t size);
 void Cleanup();
 
 } // namespace DiscScrubber
@@ -55,6 +55,7 @@ DriveReader::DriveReader(const std::string& drive)
 	if (m_file)
 	{
 #endif
+		EnableReadAhead(READ_AHEAD_BLOCKS);
 	}
 	else
 	{
@@ -64,6 +65,8 @@ DriveReader::DriveReader(const std::string& drive)
 
 DriveReader::~DriveReader()
 {
+	StopReadAhead();
+
 #ifdef _WIN32
 #ifdef _LOCKDRIVE // Do we want to lock the drive?
 	// Unlock the disc in the CD-ROM drive.
@@ -29,6 +29,8 @@ public:
 	virtual bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8 *out_ptr) override;
 
 private:
+	enum { READ_AHEAD_BLOCKS = 64 };
+
 	DriveReader(const std::string& drive);
 	void GetBlock(u64 block_num, u8 *out_ptr) override;
 
@@ -2,9 +2,21 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <string>
+
+#include "Common/StringUtil.h"
 #include "DiscIO/FileBlob.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace DiscIO
 {
 
@@ -36,4 +48,74 @@ bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 	}
 }
 
+MappedFileReader::MappedFileReader(const u8* data, u64 size)
+	: m_data(data), m_size(size)
+{
+}
+
+MappedFileReader* MappedFileReader::Create(const std::string& filename)
+{
+	if (sizeof(void*) < 8)
+		return nullptr;
+
+#ifdef _WIN32
+	HANDLE file = CreateFile(UTF8ToTStr(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+	                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &size) && size.QuadPart != 0)
+		mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	// The mapping keeps the file open
+	CloseHandle(file);
+	if (!mapping)
+		return nullptr;
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!data)
+		return nullptr;
+
+	return new MappedFileReader((const u8*)data, size.QuadPart);
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat st;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size != 0)
+		data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping keeps the file open
+	close(fd);
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	// Games mostly stream files from the disc, so let the kernel read ahead aggressively
+	madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+	return new MappedFileReader((const u8*)data, st.st_size);
+#endif
+}
+
+MappedFileReader::~MappedFileReader()
+{
+#ifdef _WIN32
+	UnmapViewOfFile(m_data);
+#else
+	munmap(const_cast<u8*>(m_data), m_size);
+#endif
+}
+
+bool MappedFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
+{
+	if (offset > m_size || nbytes > m_size - offset)
+		return false;
+
+	memcpy(out_ptr, m_data + offset, nbytes);
+	return true;
+}
+
 }  // namespace
@@ -30,4 +30,27 @@ private:
 	s64 m_size;
 };
 
+// Maps the whole image into the address space, so reads are a memcpy instead of a seek and
+// fread. Only used on 64-bit hosts, since a Wii disc doesn't fit into a 32-bit address space.
+// Reads have no error path: if the file goes away (a USB or network drive being disconnected)
+// or gets truncated by another process, the memcpy faults with SIGBUS, or EXCEPTION_IN_PAGE_ERROR
+// on Windows, and takes Dolphin down. That's why CreateBlobReader only uses it when enabled
+// with SetMapPlainImages.
+class MappedFileReader : public IBlobReader
+{
+public:
+	static MappedFileReader* Create(const std::string& filename);
+	~MappedFileReader();
+
+	u64 GetDataSize() const override { return m_size; }
+	u64 GetRawSize() const override { return m_size; }
+	bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
+
+private:
+	MappedFileReader(const u8* data, u64 size);
+
+	const u8* m_data;
+	u64 m_size;
+};
+
 }  // namespace
@@ -19,6 +19,22 @@
 
 namespace DiscIO
 {
+
+// Real FSTs are at most a few MB, this only guards against corrupt headers
+static const u64 MAX_FST_SIZE = 0x4000000;
+
+// Paths are compared like strcasecmp does, which only folds ASCII
+static std::string LowerPath(const std::string& path)
+{
+	std::string lower(path);
+	for (char& c : lower)
+	{
+		if (c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+	}
+	return lower;
+}
+
 CFileSystemGCWii::CFileSystemGCWii(const IVolume *_rVolume)
 	: IFileSystem(_rVolume)
 	, m_Initialized(false)
@@ -51,16 +67,29 @@ const std::string CFileSystemGCWii::GetFileName(u64 _Address)
 	if (!m_Initialized)
 		InitFileSystem();
 
-	for (auto& fileInfo : m_FileInfoVector)
+	// The last file which starts at or before the address
+	auto it = std::upper_bound(m_FileRanges.begin(), m_FileRanges.end(), _Address,
+		[](u64 address, const SFileRange& range) { return address < range.m_Offset; });
+
+	// Usually that file contains the address. Only overlapping files make this look further back,
+	// where the first match in FST order wins like it always did.
+	const SFileInfo* match = nullptr;
+	size_t match_index = 0;
+	while (it != m_FileRanges.begin())
 	{
-		if ((fileInfo.m_Offset <= _Address) &&
-		    ((fileInfo.m_Offset + fileInfo.m_FileSize) > _Address))
+		--it;
+		if (it->m_MaxEnd <= _Address)
+			break;
+
+		const SFileInfo& fileInfo = m_FileInfoVector[it->m_Index];
+		if (fileInfo.m_Offset + fileInfo.m_FileSize > _Address && (!match || it->m_Index < match_index))
 		{
-			return fileInfo.m_FullPath;
+			match = &fileInfo;
+			match_index = it->m_Index;
 		}
 	}
 
-	return "";
+	return match ? match->m_FullPath : "";
 }
 
 u64 CFileSystemGCWii::ReadFile(const std::string& _rFullPath, u8* _pBuffer, size_t _MaxBufferSize)
@@ -234,13 +263,11 @@ const SFileInfo* CFileSystemGCWii::FindFileInfo(const std::string& _rFullPath)
 	if (!m_Initialized)
 		InitFileSystem();
 
-	for (auto& fileInfo : m_FileInfoVector)
-	{
-		if (!strcasecmp(fileInfo.m_FullPath.c_str(), _rFullPath.c_str()))
-			return &fileInfo;
-	}
+	auto it = m_PathIndex.find(LowerPath(_rFullPath));
+	if (it == m_PathIndex.end())
+		return nullptr;
 
-	return nullptr;
+	return &m_FileInfoVector[it->second];
 }
 
 bool CFileSystemGCWii::DetectFileSystem()
@@ -266,7 +293,7 @@ void CFileSystemGCWii::InitFileSystem()
 
 	// read the whole FST
 	u64 FSTOffset = static_cast<u64>(Read32(0x424)) << shift;
-	// u32 FSTSize     = Read32(0x428);
+	u64 FSTSize = static_cast<u64>(Read32(0x428)) << shift;
 	// u32 FSTMaxSize  = Read32(0x42C);
 
 
@@ -283,23 +310,74 @@ void CFileSystemGCWii::InitFileSystem()
 
 	if (m_FileInfoVector.size())
 		PanicAlert("Wtf?");
-	u64 NameTableOffset = FSTOffset;
+	u64 const NameTableOffset = Root.m_FileSize * 0xC;
+
+	// The entries and the name table are read at once instead of a few bytes at a time,
+	// which for Wii discs means decrypting every cluster of the FST just once.
+	// Names outside of what the header claims the size is are still read from the volume.
+	std::vector<u8> FST((size_t)std::min<u64>(std::max(FSTSize, NameTableOffset), MAX_FST_SIZE));
+	if (FST.size() < NameTableOffset || !m_rVolume->Read(FSTOffset, FST.size(), FST.data(), m_Wii))
+		return;
 
 	m_FileInfoVector.reserve((size_t)Root.m_FileSize);
 	for (u32 i = 0; i < Root.m_FileSize; i++)
 	{
-		u64 const read_offset = FSTOffset + (i * 0xC);
-		u64 const name_offset = Read32(read_offset + 0x0);
-		u64 const offset = static_cast<u64>(Read32(read_offset + 0x4)) << shift;
-		u64 const size = Read32(read_offset + 0x8);
+		const u8* entry = &FST[i * 0xC];
+		u64 const name_offset = Common::swap32(entry + 0x0);
+		u64 const offset = static_cast<u64>(Common::swap32(entry + 0x4)) << shift;
+		u64 const size = Common::swap32(entry + 0x8);
 		m_FileInfoVector.emplace_back(name_offset, offset, size);
-		NameTableOffset += 0xC;
 	}
 
-	BuildFilenames(1, m_FileInfoVector.size(), "", NameTableOffset);
+	BuildFilenames(1, m_FileInfoVector.size(), "", FST, FSTOffset, NameTableOffset);
+	BuildIndex();
+}
+
+void CFileSystemGCWii::BuildIndex()
+{
+	m_PathIndex.reserve(m_FileInfoVector.size());
+	for (size_t i = 0; i < m_FileInfoVector.size(); i++)
+	{
+		const SFileInfo& fileInfo = m_FileInfoVector[i];
+
+		// Keeps the first of several entries with the same name, like the linear search did
+		m_PathIndex.emplace(LowerPath(fileInfo.m_FullPath), i);
+
+		// For directories m_Offset and m_FileSize are FST indices
+		if (!fileInfo.IsDirectory() && fileInfo.m_FileSize != 0)
+			m_FileRanges.push_back({fileInfo.m_Offset, 0, i});
+	}
+
+	std::sort(m_FileRanges.begin(), m_FileRanges.end(), [](const SFileRange& a, const SFileRange& b)
+	{
+		return a.m_Offset < b.m_Offset || (a.m_Offset == b.m_Offset && a.m_Index < b.m_Index);
+	});
+
+	u64 max_end = 0;
+	for (SFileRange& range : m_FileRanges)
+	{
+		const SFileInfo& fileInfo = m_FileInfoVector[range.m_Index];
+		max_end = std::max(max_end, fileInfo.m_Offset + fileInfo.m_FileSize);
+		range.m_MaxEnd = max_end;
+	}
+}
+
+std::string CFileSystemGCWii::GetStringFromFST(const std::vector<u8>& _rFST, u64 _FSTOffset, u64 _Offset) const
+{
+	if (_Offset >= _rFST.size())
+		return GetStringFromOffset(_FSTOffset + _Offset);
+
+	const char* start = reinterpret_cast<const char*>(&_rFST[(size_t)_Offset]);
+	size_t length = std::min<size_t>(255, _rFST.size() - (size_t)_Offset);
+	const char* end = std::find(start, start + length, '\0');
+
+	// TODO: Should we really always use SHIFT-JIS?
+	// It makes some filenames in Pikmin (NTSC-U) sane, but is it correct?
+	return SHIFTJISToUTF8(std::string(start, end));
 }
 
-size_t CFileSystemGCWii::BuildFilenames(const size_t _FirstIndex, const size_t _LastIndex, const std::string& _szDirectory, u64 _NameTableOffset)
+size_t CFileSystemGCWii::BuildFilenames(const size_t _FirstIndex, const size_t _LastIndex, const std::string& _szDirectory,
+                                        const std::vector<u8>& _rFST, u64 _FSTOffset, u64 _NameTableOffset)
 {
 	size_t CurrentIndex = _FirstIndex;
 
@@ -307,7 +385,7 @@ size_t CFileSystemGCWii::BuildFilenames(const size_t _FirstIndex, const size_t _
 	{
 		SFileInfo& rFileInfo = m_FileInfoVector[CurrentIndex];
 		u64 const uOffset = _NameTableOffset + (rFileInfo.m_NameOffset & 0xFFFFFF);
-		std::string const offset_str { GetStringFromOffset(uOffset) };
+		std::string const offset_str { GetStringFromFST(_rFST, _FSTOffset, uOffset) };
 		bool const is_dir = rFileInfo.IsDirectory();
 		rFileInfo.m_FullPath.reserve(_szDirectory.size() + offset_str.size());
 
@@ -322,7 +400,7 @@ size_t CFileSystemGCWii::BuildFilenames(const size_t _FirstIndex, const size_t _
 		}
 
 		// check next index
-		CurrentIndex = BuildFilenames(CurrentIndex + 1, (size_t) rFileInfo.m_FileSize, rFileInfo.m_FullPath, _NameTableOffset);
+		CurrentIndex = BuildFilenames(CurrentIndex + 1, (size_t) rFileInfo.m_FileSize, rFileInfo.m_FullPath, _rFST, _FSTOffset, _NameTableOffset);
 	}
 
 	return CurrentIndex;
@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -38,12 +39,29 @@ private:
 	bool m_Wii;
 
 	std::vector <SFileInfo> m_FileInfoVector;
+
+	// Index into m_FileInfoVector by lower case path
+	std::unordered_map<std::string, size_t> m_PathIndex;
+
+	// Files sorted by offset, with the largest end offset of any file up to each one,
+	// so GetFileName can binary search even if files overlap.
+	struct SFileRange
+	{
+		u64 m_Offset;
+		u64 m_MaxEnd;
+		size_t m_Index;
+	};
+	std::vector<SFileRange> m_FileRanges;
+
 	u32 Read32(u64 _Offset) const;
 	std::string GetStringFromOffset(u64 _Offset) const;
+	std::string GetStringFromFST(const std::vector<u8>& _rFST, u64 _FSTOffset, u64 _Offset) const;
 	const SFileInfo* FindFileInfo(const std::string& _rFullPath);
 	bool DetectFileSystem();
 	void InitFileSystem();
-	size_t BuildFilenames(const size_t _FirstIndex, const size_t _LastIndex, const std::string& _szDirectory, u64 _NameTableOffset);
+	void BuildIndex();
+	size_t BuildFilenames(const size_t _FirstIndex, const size_t _LastIndex, const std::string& _szDirectory,
+	                      const std::vector<u8>& _rFST, u64 _FSTOffset, u64 _NameTableOffset);
 	u32 GetOffsetShift() const;
 };
 
@@ -2,15 +2,22 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 #include <polarssl/aes.h>
 #include <polarssl/sha1.h>
 
+#ifdef _M_X86
+#include <wmmintrin.h>
+#endif
+
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
 #include "Common/MsgHandler.h"
 #include "Common/Logging/Log.h"
 #include "DiscIO/Blob.h"
@@ -23,6 +30,62 @@
 namespace DiscIO
 {
 
+#ifdef _M_X86
+#ifdef _MSC_VER
+#define FUNCTION_TARGET_AES
+#else
+#define FUNCTION_TARGET_AES __attribute__((target("aes,sse2")))
+#endif
+
+// Unlike encryption, CBC decryption doesn't depend on the previous block's result,
+// so several blocks can be in flight to hide the latency of AESDEC.
+// Uses the inverse key schedule polarssl has already set up in the context.
+FUNCTION_TARGET_AES
+static void DecryptCBC_AESNI(const aes_context* ctx, size_t length, u8 iv[16], const u8* in, u8* out)
+{
+	const __m128i* rk = (const __m128i*)ctx->rk;
+	const int nr = ctx->nr;
+	__m128i prev = _mm_loadu_si128((const __m128i*)iv);
+
+	size_t i = 0;
+	for (; i + 4 * 16 <= length; i += 4 * 16)
+	{
+		__m128i c[4], b[4];
+		for (int j = 0; j < 4; j++)
+		{
+			c[j] = _mm_loadu_si128((const __m128i*)(in + i + j * 16));
+			b[j] = _mm_xor_si128(c[j], _mm_loadu_si128(&rk[0]));
+		}
+		for (int r = 1; r < nr; r++)
+		{
+			__m128i key = _mm_loadu_si128(&rk[r]);
+			for (int j = 0; j < 4; j++)
+				b[j] = _mm_aesdec_si128(b[j], key);
+		}
+		__m128i key = _mm_loadu_si128(&rk[nr]);
+		for (int j = 0; j < 4; j++)
+		{
+			b[j] = _mm_xor_si128(_mm_aesdeclast_si128(b[j], key), j == 0 ? prev : c[j - 1]);
+			_mm_storeu_si128((__m128i*)(out + i + j * 16), b[j]);
+		}
+		prev = c[3];
+	}
+
+	for (; i < length; i += 16)
+	{
+		__m128i c = _mm_loadu_si128((const __m128i*)(in + i));
+		__m128i b = _mm_xor_si128(c, _mm_loadu_si128(&rk[0]));
+		for (int r = 1; r < nr; r++)
+			b = _mm_aesdec_si128(b, _mm_loadu_si128(&rk[r]));
+		b = _mm_xor_si128(_mm_aesdeclast_si128(b, _mm_loadu_si128(&rk[nr])), prev);
+		_mm_storeu_si128((__m128i*)(out + i), b);
+		prev = c;
+	}
+
+	_mm_storeu_si128((__m128i*)iv, prev);
+}
+#endif
+
 CVolumeWiiCrypted::CVolumeWiiCrypted(IBlobReader* _pReader, u64 _VolumeOffset,
 									 const unsigned char* _pVolumeKey)
 	: m_pReader(_pReader),
@@ -30,16 +93,18 @@ CVolumeWiiCrypted::CVolumeWiiCrypted(IBlobReader* _pReader, u64 _VolumeOffset,
 	m_pBuffer(nullptr),
 	m_VolumeOffset(_VolumeOffset),
 	m_dataOffset(0x20000),
-	m_LastDecryptedBlockOffset(-1)
+	m_cluster_cache(new CachedCluster[s_cluster_cache_size]),
+	m_cluster_cache_counter(0)
 {
 	aes_setkey_dec(m_AES_ctx.get(), _pVolumeKey, 128);
 	m_pBuffer = new u8[s_block_total_size];
+	ClearClusterCache();
 }
 
 bool CVolumeWiiCrypted::ChangePartition(u64 offset)
 {
 	m_VolumeOffset = offset;
-	m_LastDecryptedBlockOffset = -1;
+	ClearClusterCache();
 
 	u8 volume_key[16];
 	DiscIO::VolumeKeyForParition(*m_pReader, offset, volume_key);
@@ -53,6 +118,85 @@ CVolumeWiiCrypted::~CVolumeWiiCrypted()
 	m_pBuffer = nullptr;
 }
 
+void CVolumeWiiCrypted::ClearClusterCache()
+{
+	for (unsigned int i = 0; i < s_cluster_cache_size; i++)
+	{
+		m_cluster_cache[i].block = (u64)-1;
+		m_cluster_cache[i].last_used = 0;
+	}
+}
+
+// Decrypts the data of a whole cluster (header included) into out.
+void CVolumeWiiCrypted::DecryptCluster(const u8* cluster, u8* out) const
+{
+	// The only thing we currently use from the 0x000 - 0x3FF part
+	// of the block is the IV (at 0x3D0), but it also contains SHA-1
+	// hashes that IOS uses to check that discs aren't tampered with.
+	// http://wiibrew.org/wiki/Wii_Disc#Encrypted
+	u8 iv[16];
+	memcpy(iv, cluster + 0x3D0, sizeof(iv));
+
+#ifdef _M_X86
+	if (cpu_info.bAES)
+	{
+		DecryptCBC_AESNI(m_AES_ctx.get(), s_block_data_size, iv, cluster + s_block_header_size, out);
+		return;
+	}
+#endif
+
+	aes_crypt_cbc(m_AES_ctx.get(), AES_DECRYPT, s_block_data_size, iv, cluster + s_block_header_size, out);
+}
+
+const u8* CVolumeWiiCrypted::GetDecryptedCluster(u64 block) const
+{
+	CachedCluster* entry = &m_cluster_cache[0];
+	for (unsigned int i = 0; i < s_cluster_cache_size; i++)
+	{
+		if (m_cluster_cache[i].block == block)
+		{
+			m_cluster_cache[i].last_used = ++m_cluster_cache_counter;
+			return m_cluster_cache[i].data;
+		}
+
+		if (m_cluster_cache[i].last_used < entry->last_used)
+			entry = &m_cluster_cache[i];
+	}
+
+	// Replace the least recently used cluster
+	if (!m_pReader->Read(m_VolumeOffset + m_dataOffset + block * s_block_total_size, s_block_total_size, m_pBuffer))
+		return nullptr;
+
+	DecryptCluster(m_pBuffer, entry->data);
+	entry->block = block;
+	entry->last_used = ++m_cluster_cache_counter;
+	return entry->data;
+}
+
+bool CVolumeWiiCrypted::DecryptClusters(u64 block, u64 num_blocks, u8* out) const
+{
+	std::vector<u8> clusters(num_blocks * s_block_total_size);
+	if (!m_pReader->Read(m_VolumeOffset + m_dataOffset + block * s_block_total_size, clusters.size(), clusters.data()))
+		return false;
+
+	auto decrypt = [&](u64 begin, u64 end)
+	{
+		for (u64 i = begin; i < end; i++)
+			DecryptCluster(&clusters[i * s_block_total_size], out + i * s_block_data_size);
+	};
+
+	// Every thread takes an adjacent range of clusters, the calling thread takes the first one.
+	int num_threads = std::max(1, std::min<int>(cpu_info.num_cores, (int)(num_blocks / s_min_clusters_per_thread)));
+	std::vector<std::thread> threads;
+	for (int t = 1; t < num_threads; t++)
+		threads.emplace_back(decrypt, num_blocks * t / num_threads, num_blocks * (t + 1) / num_threads);
+	decrypt(0, num_blocks / num_threads);
+	for (std::thread& thread : threads)
+		thread.join();
+
+	return true;
+}
+
 bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, bool decrypt) const
 {
 	if (m_pReader == nullptr)
@@ -69,30 +213,27 @@ bool CVolumeWiiCrypted::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, bool de
 		u64 Block  = _ReadOffset / s_block_data_size;
 		u64 Offset = _ReadOffset % s_block_data_size;
 
-		if (m_LastDecryptedBlockOffset != Block)
+		// Large reads of whole clusters bypass the cache
+		if (Offset == 0 && _Length >= s_block_data_size * s_min_clusters_per_thread)
 		{
-			// Read the current block
-			if (!m_pReader->Read(m_VolumeOffset + m_dataOffset + Block * s_block_total_size, s_block_total_size, m_pBuffer))
+			u64 num_blocks = _Length / s_block_data_size;
+			if (!DecryptClusters(Block, num_blocks, _pBuffer))
 				return false;
 
-			// Decrypt the block's data.
-			// 0x3D0 - 0x3DF in m_pBuffer will be overwritten,
-			// but that won't affect anything, because we won't
-			// use the content of m_pBuffer anymore after this
-			aes_crypt_cbc(m_AES_ctx.get(), AES_DECRYPT, s_block_data_size, m_pBuffer + 0x3D0,
-			              m_pBuffer + s_block_header_size, m_LastDecryptedBlock);
-			m_LastDecryptedBlockOffset = Block;
-
-			// The only thing we currently use from the 0x000 - 0x3FF part
-			// of the block is the IV (at 0x3D0), but it also contains SHA-1
-			// hashes that IOS uses to check that discs aren't tampered with.
-			// http://wiibrew.org/wiki/Wii_Disc#Encrypted
+			_Length     -= num_blocks * s_block_data_size;
+			_pBuffer    += num_blocks * s_block_data_size;
+			_ReadOffset += num_blocks * s_block_data_size;
+			continue;
 		}
 
+		const u8* data = GetDecryptedCluster(Block);
+		if (!data)
+			return false;
+
 		// Copy the decrypted data
 		u64 MaxSizeToCopy = s_block_data_size - Offset;
 		u64 CopySize = (_Length > MaxSizeToCopy) ? MaxSizeToCopy : _Length;
-		memcpy(_pBuffer, &m_LastDecryptedBlock[Offset], (size_t)CopySize);
+		memcpy(_pBuffer, &data[Offset], (size_t)CopySize);
 
 		// Update offsets
 		_Length -= CopySize;
@@ -48,6 +48,25 @@ private:
 	static const unsigned int s_block_data_size   = 0x7C00;
 	static const unsigned int s_block_total_size  = s_block_header_size + s_block_data_size;
 
+	// Number of decrypted clusters which are kept around, so that interleaved reads from
+	// several files don't decrypt the same clusters over and over again.
+	static const unsigned int s_cluster_cache_size = 16;
+	// Reads of at least this many whole clusters are decrypted straight into the
+	// destination, on several threads if there are enough of them.
+	static const unsigned int s_min_clusters_per_thread = 4;
+
+	struct CachedCluster
+	{
+		u64 block;
+		u64 last_used;
+		u8 data[s_block_data_size];
+	};
+
+	void DecryptCluster(const u8* cluster, u8* out) const;
+	bool DecryptClusters(u64 block, u64 num_blocks, u8* out) const;
+	const u8* GetDecryptedCluster(u64 block) const;
+	void ClearClusterCache();
+
 	std::unique_ptr<IBlobReader> m_pReader;
 	std::unique_ptr<aes_context> m_AES_ctx;
 
@@ -56,8 +75,8 @@ private:
 	u64 m_VolumeOffset;
 	u64 m_dataOffset;
 
-	mutable u64 m_LastDecryptedBlockOffset;
-	mutable unsigned char m_LastDecryptedBlock[s_block_data_size];
+	std::unique_ptr<CachedCluster[]> m_cluster_cache;
+	mutable u64 m_cluster_cache_counter;
 };
 
 } // namespace
@@ -11,6 +11,7 @@
 
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexShaderGen.h"
 
 namespace OGL
@@ -431,6 +432,8 @@ void FramebufferManager::CopyToRealXFB(u32 xfbAddr, u32 fbWidth, u32 fbHeight, c
 		return;
 	}
 
+	g_texture_cache->FlushEFBCopiesInRange(xfbAddr, fbWidth * fbHeight * 2);
+
 	TargetRectangle targetRc = g_renderer->ConvertEFBRectangle(sourceRc);
 	TextureConverter::EncodeToRamYUYV(ResolveAndGetRenderTarget(sourceRc), targetRc, xfb_in_ram, fbWidth, fbHeight);
 }
@@ -18,6 +18,22 @@ typedef int ( * PFNGLXSWAPINTERVALSGIPROC) (int interval);
 static PFNGLXCREATECONTEXTATTRIBSPROC glXCreateContextAttribs = nullptr;
 static PFNGLXSWAPINTERVALSGIPROC glXSwapIntervalSGI = nullptr;
 
+static const int s_context_attribs[] =
+{
+	GLX_CONTEXT_MAJOR_VERSION_ARB, 3,
+	GLX_CONTEXT_MINOR_VERSION_ARB, 3,
+	GLX_CONTEXT_PROFILE_MASK_ARB,  GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+	GLX_CONTEXT_FLAGS_ARB,         GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
+	None
+};
+
+static const int s_context_attribs_legacy[] =
+{
+	GLX_CONTEXT_MAJOR_VERSION_ARB, 1,
+	GLX_CONTEXT_MINOR_VERSION_ARB, 0,
+	None
+};
+
 static bool s_glxError;
 static int ctxErrorHandler(Display *dpy, XErrorEvent *ev)
 {
@@ -96,28 +112,15 @@ bool cInterfaceGLX::Create(void *window_handle)
 
 	// Create a GLX context.
 	// We try to get a 3.3 core profile, else we try it with anything we get.
-	int context_attribs[] =
-	{
-		GLX_CONTEXT_MAJOR_VERSION_ARB, 3,
-		GLX_CONTEXT_MINOR_VERSION_ARB, 3,
-		GLX_CONTEXT_PROFILE_MASK_ARB,  GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
-		GLX_CONTEXT_FLAGS_ARB,         GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
-		None
-	};
 	s_glxError = false;
 	XErrorHandler oldHandler = XSetErrorHandler(&ctxErrorHandler);
-	ctx = glXCreateContextAttribs(dpy, fbconfig, 0, True, context_attribs);
+	ctx = glXCreateContextAttribs(dpy, fbconfig, 0, True, s_context_attribs);
 	XSync(dpy, False);
 	if (!ctx || s_glxError)
 	{
-		int context_attribs_legacy[] =
-		{
-			GLX_CONTEXT_MAJOR_VERSION_ARB, 1,
-			GLX_CONTEXT_MINOR_VERSION_ARB, 0,
-			None
-		};
 		s_glxError = false;
-		ctx = glXCreateContextAttribs(dpy, fbconfig, 0, True, context_attribs_legacy);
+		core_profile = false;
+		ctx = glXCreateContextAttribs(dpy, fbconfig, 0, True, s_context_attribs_legacy);
 		XSync(dpy, False);
 		if (!ctx || s_glxError)
 		{
@@ -145,8 +148,70 @@ bool cInterfaceGLX::Create(void *window_handle)
 	return true;
 }
 
+cInterfaceBase* cInterfaceGLX::CreateSharedContext()
+{
+	// Shared contexts never present anything, so a 1x1 pbuffer is enough to make them current.
+	int visual_attribs[] =
+	{
+		GLX_DRAWABLE_TYPE   , GLX_PBUFFER_BIT,
+		GLX_RENDER_TYPE     , GLX_RGBA_BIT,
+		GLX_RED_SIZE        , 8,
+		GLX_GREEN_SIZE      , 8,
+		GLX_BLUE_SIZE       , 8,
+		None
+	};
+	int fbcount = 0;
+	GLXFBConfig* fbc = glXChooseFBConfig(dpy, DefaultScreen(dpy), visual_attribs, &fbcount);
+	if (!fbc || !fbcount)
+	{
+		ERROR_LOG(VIDEO, "Failed to retrieve a pbuffer framebuffer config");
+		return nullptr;
+	}
+
+	cInterfaceGLX* shared = new cInterfaceGLX;
+	shared->dpy = dpy;
+	shared->win = None;
+	shared->vi = nullptr;
+	shared->fbconfig = *fbc;
+	shared->core_profile = core_profile;
+	XFree(fbc);
+
+	s_glxError = false;
+	XErrorHandler oldHandler = XSetErrorHandler(&ctxErrorHandler);
+	shared->ctx = glXCreateContextAttribs(dpy, shared->fbconfig, ctx, True,
+	                                      core_profile ? s_context_attribs : s_context_attribs_legacy);
+	XSync(dpy, False);
+	XSetErrorHandler(oldHandler);
+	if (!shared->ctx || s_glxError)
+	{
+		ERROR_LOG(VIDEO, "Unable to create shared GL context.");
+		delete shared;
+		return nullptr;
+	}
+
+	int pbuffer_attribs[] =
+	{
+		GLX_PBUFFER_WIDTH , 1,
+		GLX_PBUFFER_HEIGHT, 1,
+		None
+	};
+	shared->pbuffer = glXCreatePbuffer(dpy, shared->fbconfig, pbuffer_attribs);
+	if (!shared->pbuffer)
+	{
+		ERROR_LOG(VIDEO, "Unable to create pbuffer for shared GL context.");
+		glXDestroyContext(dpy, shared->ctx);
+		delete shared;
+		return nullptr;
+	}
+
+	return shared;
+}
+
 bool cInterfaceGLX::MakeCurrent()
 {
+	if (pbuffer)
+		return glXMakeContextCurrent(dpy, pbuffer, pbuffer, ctx);
+
 	bool success = glXMakeCurrent(dpy, win, ctx);
 	if (success)
 	{
@@ -165,6 +230,16 @@ bool cInterfaceGLX::ClearCurrent()
 // Close backend
 void cInterfaceGLX::Shutdown()
 {
+	// Shared contexts borrow the display connection of the main one.
+	if (pbuffer)
+	{
+		glXDestroyPbuffer(dpy, pbuffer);
+		glXDestroyContext(dpy, ctx);
+		pbuffer = 0;
+		ctx = nullptr;
+		return;
+	}
+
 	XWindow.DestroyXWindow();
 	if (ctx)
 	{
@@ -19,6 +19,8 @@ private:
 	GLXContext ctx;
 	XVisualInfo *vi;
 	GLXFBConfig fbconfig;
+	GLXPbuffer pbuffer = 0;
+	bool core_profile = true;
 public:
 	friend class cX11Window;
 	void SwapInterval(int Interval) override;
@@ -28,4 +30,5 @@ public:
 	bool MakeCurrent() override;
 	bool ClearCurrent() override;
 	void Shutdown() override;
+	cInterfaceBase* CreateSharedContext() override;
 };
@@ -40,6 +40,10 @@ public:
 	virtual void SetBackBufferDimensions(u32 W, u32 H) {s_backbuffer_width = W; s_backbuffer_height = H; }
 	virtual void Update() { }
 	virtual bool PeekMessages() { return false; }
+
+	// Creates an offscreen context which shares objects with this one, for use
+	// on a worker thread. Returns nullptr if the platform can't do this.
+	virtual cInterfaceBase* CreateSharedContext() { return nullptr; }
 };
 
 extern cInterfaceBase *GLInterface;
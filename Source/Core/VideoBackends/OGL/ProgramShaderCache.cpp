@@ -2,15 +2,31 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "Common/CPUDetect.h"
+#include "Common/Event.h"
 #include "Common/MathUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "Common/Timer.h"
+
+#include "Core/Host.h"
 
 #include "VideoBackends/OGL/ProgramShaderCache.h"
 #include "VideoBackends/OGL/Render.h"
 #include "VideoBackends/OGL/StreamBuffer.h"
 
+#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/GeometryShaderManager.h"
@@ -41,6 +57,49 @@ UidChecker<GeometryShaderUid,ShaderCode> ProgramShaderCache::geometry_uid_checke
 
 static char s_glsl_header[1024] = "";
 
+// The uid of the current state and the draw parameters it was generated for, see UpdateShaderId.
+static SHADERUID s_current_uid;
+static bool s_current_uid_valid;
+static DSTALPHA_MODE s_current_dstalpha_mode;
+static u32 s_current_components;
+static u32 s_current_primitive_type;
+static bool s_current_bbox_active;
+
+// Asynchronous shader compilation. Programs are linked on worker threads which
+// own a context sharing objects with the main one; draws using a program which
+// isn't ready yet are skipped.
+struct AsyncCompileJob
+{
+	SHADERUID uid;
+	std::string vcode, pcode, gcode;
+	GLuint program;
+};
+
+static std::vector<std::thread> s_compile_threads;
+static std::vector<cInterfaceBase*> s_compile_contexts;
+static std::condition_variable s_compile_cv;
+static Common::Event s_compile_done;
+static std::mutex s_compile_mutex;
+static std::deque<std::unique_ptr<AsyncCompileJob>> s_compile_queue;
+static std::deque<std::unique_ptr<AsyncCompileJob>> s_compile_finished;
+static std::atomic<u32> s_compile_pending;
+static bool s_compile_threads_running = false;
+
+// Log of the GLSL sources of every program generated for the current game, only kept
+// while PrecompileShaders is enabled. The generated code depends on the backend features,
+// so the first entry holds a signature of them and of the driver, see GetSourceLogSignature.
+static LinearDiskCache<SHADERUID, char> s_source_log;
+static std::set<SHADERUID> s_source_log_uids;
+static bool s_source_log_open = false;
+
+static std::string GetSourceLogSignature()
+{
+	const auto& info = g_ActiveConfig.backend_info;
+	return StringFromFormat("%s|%s|%s|%d%d%d%d%d%d%d", g_ogl_config.gl_vendor, g_ogl_config.gl_renderer,
+		g_ogl_config.gl_version, info.bSupportsDualSourceBlend, info.bSupportsEarlyZ, info.bSupportsBindingLayout,
+		info.bSupportsBBox, info.bSupportsGeometryShaders, info.bSupportsGSInstancing, info.bSupportsPrimitiveRestart);
+}
+
 static std::string GetGLSLVersionString()
 {
 	GLSL_VERSION v = g_ogl_config.eSupportedGLSLVersion;
@@ -173,14 +232,20 @@ GLuint ProgramShaderCache::GetCurrentProgram()
 
 SHADER* ProgramShaderCache::SetShader(DSTALPHA_MODE dstAlphaMode, u32 components, u32 primitive_type)
 {
-	SHADERUID uid;
-	GetShaderId(&uid, dstAlphaMode, components, primitive_type);
+	bool uid_changed = UpdateShaderId(dstAlphaMode, components, primitive_type);
+	const SHADERUID& uid = s_current_uid;
+
+	if (s_compile_pending)
+		RetrieveAsyncShaders();
 
 	// Check if the shader is already set
 	if (last_entry)
 	{
-		if (uid == last_uid)
+		if (!uid_changed || uid == last_uid)
 		{
+			if (last_entry->pending)
+				return nullptr;
+
 			GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
 			last_entry->shader.Bind();
 			return &last_entry->shader;
@@ -196,6 +261,9 @@ SHADER* ProgramShaderCache::SetShader(DSTALPHA_MODE dstAlphaMode, u32 components
 		PCacheEntry *entry = &iter->second;
 		last_entry = entry;
 
+		if (last_entry->pending)
+			return nullptr;
+
 		GFX_DEBUGGER_PAUSE_AT(NEXT_PIXEL_SHADER_CHANGE, true);
 		last_entry->shader.Bind();
 		return &last_entry->shader;
@@ -205,6 +273,7 @@ SHADER* ProgramShaderCache::SetShader(DSTALPHA_MODE dstAlphaMode, u32 components
 	PCacheEntry& newentry = pshaders[uid];
 	last_entry = &newentry;
 	newentry.in_cache = 0;
+	newentry.pending = false;
 
 	VertexShaderCode vcode;
 	PixelShaderCode pcode;
@@ -239,6 +308,15 @@ SHADER* ProgramShaderCache::SetShader(DSTALPHA_MODE dstAlphaMode, u32 components
 	}
 #endif
 
+	AppendToSourceLog(uid, vcode.GetBuffer(), pcode.GetBuffer(), gcode.GetBuffer());
+
+	if (s_compile_threads_running)
+	{
+		newentry.pending = true;
+		QueueAsyncCompile(uid, vcode.GetBuffer(), pcode.GetBuffer(), gcode.GetBuffer());
+		return nullptr;
+	}
+
 	if (!CompileShader(newentry.shader, vcode.GetBuffer(), pcode.GetBuffer(), gcode.GetBuffer()))
 	{
 		GFX_DEBUGGER_PAUSE_AT(NEXT_ERROR, true);
@@ -254,6 +332,16 @@ SHADER* ProgramShaderCache::SetShader(DSTALPHA_MODE dstAlphaMode, u32 components
 }
 
 bool ProgramShaderCache::CompileShader(SHADER& shader, const char* vcode, const char* pcode, const char* gcode)
+{
+	if (!LinkProgram(shader, vcode, pcode, gcode))
+		return false;
+
+	shader.SetProgramVariables();
+
+	return true;
+}
+
+bool ProgramShaderCache::LinkProgram(SHADER& shader, const char* vcode, const char* pcode, const char* gcode)
 {
 	GLuint vsid = CompileSingleShader(GL_VERTEX_SHADER, vcode);
 	GLuint psid = CompileSingleShader(GL_FRAGMENT_SHADER, pcode);
@@ -329,11 +417,10 @@ bool ProgramShaderCache::CompileShader(SHADER& shader, const char* vcode, const
 
 		// Don't try to use this shader
 		glDeleteProgram(pid);
+		shader.glprogid = 0;
 		return false;
 	}
 
-	shader.SetProgramVariables();
-
 	return true;
 }
 
@@ -395,11 +482,40 @@ GLuint ProgramShaderCache::CompileSingleShader(GLuint type, const char* code)
 	return result;
 }
 
-void ProgramShaderCache::GetShaderId(SHADERUID* uid, DSTALPHA_MODE dstAlphaMode, u32 components, u32 primitive_type)
+bool ProgramShaderCache::UpdateShaderId(DSTALPHA_MODE dstAlphaMode, u32 components, u32 primitive_type)
 {
-	GetPixelShaderUid(uid->puid, dstAlphaMode, API_OPENGL, components);
-	GetVertexShaderUid(uid->vuid, components, API_OPENGL);
-	GetGeometryShaderUid(uid->guid, primitive_type, API_OPENGL);
+	SHADERUID* uid = &s_current_uid;
+
+	// Only regenerate the stages whose inputs changed since the last call.
+	// Shader debugging needs the generated code, so always do everything then.
+	bool regenerate_all = !s_current_uid_valid || g_ActiveConfig.bEnableShaderDebugging;
+	bool pixel_changed = regenerate_all || PixelShaderManager::uid_dirty ||
+	                     dstAlphaMode != s_current_dstalpha_mode || components != s_current_components ||
+	                     BoundingBox::active != s_current_bbox_active;
+	bool vertex_changed = regenerate_all || VertexShaderManager::uid_dirty || components != s_current_components;
+	bool geometry_changed = regenerate_all || GeometryShaderManager::uid_dirty || primitive_type != s_current_primitive_type;
+
+	if (pixel_changed)
+	{
+		GetPixelShaderUid(uid->puid, dstAlphaMode, API_OPENGL, components);
+		PixelShaderManager::uid_dirty = false;
+	}
+	if (vertex_changed)
+	{
+		GetVertexShaderUid(uid->vuid, components, API_OPENGL);
+		VertexShaderManager::uid_dirty = false;
+	}
+	if (geometry_changed)
+	{
+		GetGeometryShaderUid(uid->guid, primitive_type, API_OPENGL);
+		GeometryShaderManager::uid_dirty = false;
+	}
+
+	s_current_uid_valid = true;
+	s_current_dstalpha_mode = dstAlphaMode;
+	s_current_components = components;
+	s_current_primitive_type = primitive_type;
+	s_current_bbox_active = BoundingBox::active;
 
 	if (g_ActiveConfig.bEnableShaderDebugging)
 	{
@@ -415,6 +531,8 @@ void ProgramShaderCache::GetShaderId(SHADERUID* uid, DSTALPHA_MODE dstAlphaMode,
 		GenerateGeometryShaderCode(gcode, primitive_type, API_OPENGL);
 		geometry_uid_checker.AddToIndexAndCheck(gcode, uid->guid, "Geometry", "g");
 	}
+
+	return pixel_changed || vertex_changed || geometry_changed;
 }
 
 ProgramShaderCache::PCacheEntry ProgramShaderCache::GetShaderProgram()
@@ -422,6 +540,195 @@ ProgramShaderCache::PCacheEntry ProgramShaderCache::GetShaderProgram()
 	return *last_entry;
 }
 
+u32 ProgramShaderCache::GetPendingShaderCount()
+{
+	return s_compile_pending;
+}
+
+void ProgramShaderCache::QueueAsyncCompile(const SHADERUID& uid, const char* vcode, const char* pcode, const char* gcode)
+{
+	std::unique_ptr<AsyncCompileJob> job(new AsyncCompileJob);
+	job->uid = uid;
+	job->vcode = vcode;
+	job->pcode = pcode;
+	if (gcode)
+		job->gcode = gcode;
+	job->program = 0;
+
+	{
+		std::lock_guard<std::mutex> lk(s_compile_mutex);
+		s_compile_queue.push_back(std::move(job));
+	}
+	s_compile_pending++;
+	SETSTAT(stats.numShaderCompilesPending, s_compile_pending);
+	s_compile_cv.notify_one();
+}
+
+void ProgramShaderCache::RetrieveAsyncShaders()
+{
+	std::deque<std::unique_ptr<AsyncCompileJob>> finished;
+	{
+		std::lock_guard<std::mutex> lk(s_compile_mutex);
+		finished.swap(s_compile_finished);
+	}
+
+	for (auto& job : finished)
+	{
+		PCacheEntry& entry = pshaders[job->uid];
+		entry.shader.glprogid = job->program;
+		entry.pending = false;
+
+		// The uniform and sampler bindings are set from this thread since they
+		// require binding the program.
+		if (entry.shader.glprogid)
+		{
+			entry.shader.SetProgramVariables();
+			INCSTAT(stats.numPixelShadersCreated);
+		}
+		s_compile_pending--;
+	}
+
+	SETSTAT(stats.numShaderCompilesPending, s_compile_pending);
+	SETSTAT(stats.numPixelShadersAlive, pshaders.size());
+}
+
+void ProgramShaderCache::CompileThread(cInterfaceBase* context)
+{
+	Common::SetCurrentThreadName("Shader Compiler");
+	context->MakeCurrent();
+
+	std::unique_lock<std::mutex> lk(s_compile_mutex);
+	while (true)
+	{
+		s_compile_cv.wait(lk, [] { return !s_compile_threads_running || !s_compile_queue.empty(); });
+		if (!s_compile_threads_running)
+			break;
+
+		std::unique_ptr<AsyncCompileJob> job = std::move(s_compile_queue.front());
+		s_compile_queue.pop_front();
+		lk.unlock();
+
+		SHADER shader;
+		LinkProgram(shader, job->vcode.c_str(), job->pcode.c_str(), job->gcode.empty() ? nullptr : job->gcode.c_str());
+		job->program = shader.glprogid;
+
+		// The program must be complete before another context may use it.
+		glFinish();
+
+		lk.lock();
+		s_compile_finished.push_back(std::move(job));
+		s_compile_done.Set();
+	}
+	lk.unlock();
+
+	context->ClearCurrent();
+}
+
+u32 ProgramShaderCache::StartCompileThreads(u32 count)
+{
+	for (u32 i = 0; i < count; ++i)
+	{
+		cInterfaceBase* context = GLInterface->CreateSharedContext();
+		if (!context)
+			break;
+		s_compile_contexts.push_back(context);
+	}
+
+	if (s_compile_contexts.empty())
+		return 0;
+
+	s_compile_threads_running = true;
+	for (cInterfaceBase* context : s_compile_contexts)
+		s_compile_threads.emplace_back(CompileThread, context);
+
+	return (u32)s_compile_threads.size();
+}
+
+void ProgramShaderCache::StopCompileThreads()
+{
+	if (!s_compile_threads_running)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lk(s_compile_mutex);
+		s_compile_threads_running = false;
+	}
+	s_compile_cv.notify_all();
+	for (std::thread& thread : s_compile_threads)
+		thread.join();
+	s_compile_threads.clear();
+
+	// Jobs which never got compiled remain pending, they are destroyed along with the cache.
+	s_compile_queue.clear();
+	RetrieveAsyncShaders();
+	s_compile_pending = 0;
+
+	for (cInterfaceBase* context : s_compile_contexts)
+	{
+		context->Shutdown();
+		delete context;
+	}
+	s_compile_contexts.clear();
+}
+
+void ProgramShaderCache::AppendToSourceLog(const SHADERUID& uid, const char* vcode, const char* pcode, const char* gcode)
+{
+	if (!s_source_log_open || !s_source_log_uids.insert(uid).second)
+		return;
+
+	// Stored as three consecutive null-terminated strings.
+	std::string sources = std::string(vcode) + '\0' + pcode + '\0' + (gcode ? gcode : "") + '\0';
+	s_source_log.Append(uid, sources.data(), (u32)sources.size());
+}
+
+void ProgramShaderCache::PrecompileShaders(const std::vector<SourceLogEntry>& entries)
+{
+	std::vector<const SourceLogEntry*> to_compile;
+	for (const SourceLogEntry& entry : entries)
+	{
+		if (pshaders.find(entry.uid) == pshaders.end())
+			to_compile.push_back(&entry);
+	}
+	if (to_compile.empty())
+		return;
+
+	Common::Timer timer;
+	timer.Start();
+
+	const u32 total = (u32)to_compile.size();
+	u32 thread_count = std::min(std::max(cpu_info.num_cores, 1), 8);
+	thread_count = StartCompileThreads(thread_count);
+
+	for (const SourceLogEntry* entry : to_compile)
+	{
+		PCacheEntry& newentry = pshaders[entry->uid];
+		newentry.in_cache = 0;
+		newentry.pending = false;
+
+		const char* gcode = entry->gcode.empty() ? nullptr : entry->gcode.c_str();
+		if (thread_count)
+		{
+			newentry.pending = true;
+			QueueAsyncCompile(entry->uid, entry->vcode.c_str(), entry->pcode.c_str(), gcode);
+		}
+		else if (CompileShader(newentry.shader, entry->vcode.c_str(), entry->pcode.c_str(), gcode))
+		{
+			INCSTAT(stats.numPixelShadersCreated);
+		}
+	}
+
+	while (s_compile_pending)
+	{
+		Host_UpdateTitle(StringFromFormat("Compiling shaders: %u/%u", total - s_compile_pending, total));
+		s_compile_done.WaitFor(std::chrono::milliseconds(100));
+		RetrieveAsyncShaders();
+	}
+	StopCompileThreads();
+
+	SETSTAT(stats.numPixelShadersAlive, pshaders.size());
+	NOTICE_LOG(VIDEO, "Precompiled %u shaders on %u threads in %u ms", total, std::max(thread_count, 1u), (u32)timer.GetTimeElapsed());
+}
+
 void ProgramShaderCache::Init()
 {
 	// We have to get the UBO alignment here because
@@ -436,6 +743,9 @@ void ProgramShaderCache::Init()
 	// Then once more to get bytes
 	s_buffer = StreamBuffer::Create(GL_UNIFORM_BUFFER, UBO_LENGTH);
 
+	if (!g_Config.bEnableShaderDebugging && !File::Exists(File::GetUserPath(D_SHADERCACHE_IDX)))
+		File::CreateDir(File::GetUserPath(D_SHADERCACHE_IDX));
+
 	// Read our shader cache, only if supported
 	if (g_ogl_config.bSupportsGLSLCache && !g_Config.bEnableShaderDebugging)
 	{
@@ -448,9 +758,6 @@ void ProgramShaderCache::Init()
 		}
 		else
 		{
-			if (!File::Exists(File::GetUserPath(D_SHADERCACHE_IDX)))
-				File::CreateDir(File::GetUserPath(D_SHADERCACHE_IDX));
-
 			std::string cache_filename = StringFromFormat("%sogl-%s-shaders.cache", File::GetUserPath(D_SHADERCACHE_IDX).c_str(),
 				SConfig::GetInstance().m_LocalCoreStartupParameter.m_strUniqueID.c_str());
 
@@ -464,16 +771,58 @@ void ProgramShaderCache::Init()
 
 	CurrentProgram = 0;
 	last_entry = nullptr;
+	s_current_uid_valid = false;
+
+	if (g_ActiveConfig.bPrecompileShaders && !g_Config.bEnableShaderDebugging)
+	{
+		std::string log_filename = StringFromFormat("%sogl-%s-sources.cache", File::GetUserPath(D_SHADERCACHE_IDX).c_str(),
+			SConfig::GetInstance().m_LocalCoreStartupParameter.m_strUniqueID.c_str());
+		const std::string signature = GetSourceLogSignature();
+
+		SourceLogReader reader;
+		s_source_log.OpenAndRead(log_filename, reader);
+		if (!reader.has_signature || reader.signature != signature)
+		{
+			// The sources were generated for another driver or feature set, so start a new log.
+			s_source_log.Close();
+			File::Delete(log_filename);
+			reader.entries.clear();
+			s_source_log.OpenAndRead(log_filename, reader);
+			s_source_log.Append(SHADERUID(), signature.data(), (u32)signature.size());
+		}
+		s_source_log_open = true;
+
+		for (const SourceLogEntry& entry : reader.entries)
+			s_source_log_uids.insert(entry.uid);
+
+		PrecompileShaders(reader.entries);
+	}
+
+	if (g_ActiveConfig.bAsyncShaderCompilation && !g_ActiveConfig.bEnableShaderDebugging &&
+	    !StartCompileThreads(1))
+	{
+		WARN_LOG(VIDEO, "Shared GL contexts are unsupported, shaders will be compiled synchronously.");
+	}
 }
 
 void ProgramShaderCache::Shutdown()
 {
+	StopCompileThreads();
+
+	if (s_source_log_open)
+	{
+		s_source_log.Sync();
+		s_source_log.Close();
+		s_source_log_uids.clear();
+		s_source_log_open = false;
+	}
+
 	// store all shaders in cache on disk
 	if (g_ogl_config.bSupportsGLSLCache && !g_Config.bEnableShaderDebugging)
 	{
 		for (auto& entry : pshaders)
 		{
-			if (entry.second.in_cache)
+			if (entry.second.in_cache || !entry.second.shader.glprogid)
 			{
 				continue;
 			}
@@ -582,6 +931,7 @@ void ProgramShaderCache::ProgramShaderCacheInserter::Read(const SHADERUID& key,
 
 	PCacheEntry entry;
 	entry.in_cache = 1;
+	entry.pending = false;
 	entry.shader.glprogid = glCreateProgram();
 	glProgramBinary(entry.shader.glprogid, *prog_format, binary, binary_size);
 
@@ -599,5 +949,33 @@ void ProgramShaderCache::ProgramShaderCacheInserter::Read(const SHADERUID& key,
 	}
 }
 
+void ProgramShaderCache::SourceLogReader::Read(const SHADERUID& key, const char* value, u32 value_size)
+{
+	if (!has_signature)
+	{
+		signature.assign(value, value_size);
+		has_signature = true;
+		return;
+	}
+
+	const char* sources[3];
+	const char* end = value + value_size;
+	const char* ptr = value;
+	for (const char*& source : sources)
+	{
+		const char* terminator = std::find(ptr, end, '\0');
+		if (terminator == end)
+			return;
+		source = ptr;
+		ptr = terminator + 1;
+	}
+
+	SourceLogEntry entry;
+	entry.uid = key;
+	entry.vcode = sources[0];
+	entry.pcode = sources[1];
+	entry.gcode = sources[2];
+	entries.push_back(std::move(entry));
+}
 
 } // namespace OGL
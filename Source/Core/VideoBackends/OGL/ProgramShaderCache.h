@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "Common/LinearDiskCache.h"
+#include "VideoBackends/OGL/GLInterfaceBase.h"
 #include "Core/ConfigManager.h"
 #include "VideoBackends/OGL/GLUtil.h"
 #include "VideoCommon/GeometryShaderGen.h"
@@ -77,6 +81,7 @@ public:
 	{
 		SHADER shader;
 		bool in_cache;
+		bool pending; // still being compiled on the async compile thread
 
 		void Destroy()
 		{
@@ -89,7 +94,6 @@ public:
 	static PCacheEntry GetShaderProgram();
 	static GLuint GetCurrentProgram();
 	static SHADER* SetShader(DSTALPHA_MODE dstAlphaMode, u32 components, u32 primitive_type);
-	static void GetShaderId(SHADERUID *uid, DSTALPHA_MODE dstAlphaMode, u32 components, u32 primitive_type);
 
 	static bool CompileShader(SHADER &shader, const char* vcode, const char* pcode, const char* gcode = nullptr);
 	static GLuint CompileSingleShader(GLuint type, const char *code);
@@ -99,6 +103,9 @@ public:
 	static void Shutdown();
 	static void CreateHeader();
 
+	// Returns the number of programs which are queued for asynchronous compilation.
+	static u32 GetPendingShaderCount();
+
 private:
 	class ProgramShaderCacheInserter : public LinearDiskCacheReader<SHADERUID, u8>
 	{
@@ -106,6 +113,36 @@ private:
 		void Read(const SHADERUID &key, const u8 *value, u32 value_size) override;
 	};
 
+	struct SourceLogEntry
+	{
+		SHADERUID uid;
+		std::string vcode, pcode, gcode;
+	};
+
+	class SourceLogReader : public LinearDiskCacheReader<SHADERUID, char>
+	{
+	public:
+		void Read(const SHADERUID &key, const char *value, u32 value_size) override;
+
+		std::string signature;
+		bool has_signature = false;
+		std::vector<SourceLogEntry> entries;
+	};
+
+	// Brings the uid of the current state up to date, regenerating only the stages whose
+	// inputs were flagged dirty. Returns false if it can't have changed since the last call.
+	static bool UpdateShaderId(DSTALPHA_MODE dstAlphaMode, u32 components, u32 primitive_type);
+	static bool LinkProgram(SHADER& shader, const char* vcode, const char* pcode, const char* gcode);
+	static void QueueAsyncCompile(const SHADERUID& uid, const char* vcode, const char* pcode, const char* gcode);
+	static void RetrieveAsyncShaders();
+	// Returns the number of compile threads which could be started.
+	static u32 StartCompileThreads(u32 count);
+	static void StopCompileThreads();
+	static void CompileThread(cInterfaceBase* context);
+
+	static void AppendToSourceLog(const SHADERUID& uid, const char* vcode, const char* pcode, const char* gcode);
+	static void PrecompileShaders(const std::vector<SourceLogEntry>& entries);
+
 	static PCache pshaders;
 	static PCacheEntry* last_entry;
 	static SHADERUID last_uid;
@@ -103,6 +103,14 @@ static bool s_efbCacheValid[2][EFB_CACHE_WIDTH * EFB_CACHE_HEIGHT];
 static bool s_efbCacheIsCleared = false;
 static std::vector<u32> s_efbCache[2][EFB_CACHE_WIDTH * EFB_CACHE_HEIGHT]; // 2 for PEEK_Z and PEEK_COLOR
 
+// Asynchronous EFB peeks: the first peek of a frame reads back the whole EFB into a PBO,
+// the data is fetched on the next swap and serves the peeks of the following frame.
+static GLuint s_efbPeekPBO[2];
+static GLsync s_efbPeekFence[2];
+static bool s_efbPeekPending[2];
+static TargetRectangle s_efbPeekTargetRc[2];
+static std::vector<u32> s_efbPeekData[2];
+
 static int GetNumMSAASamples(int MSAAMode)
 {
 	int samples;
@@ -670,6 +678,15 @@ Renderer::Renderer()
 
 Renderer::~Renderer()
 {
+	for (int i = 0; i < 2; ++i)
+	{
+		if (s_efbPeekPending[i])
+			glDeleteSync(s_efbPeekFence[i]);
+		s_efbPeekPending[i] = false;
+		s_efbPeekData[i].clear();
+	}
+	glDeleteBuffers(2, s_efbPeekPBO);
+	memset(s_efbPeekPBO, 0, sizeof(s_efbPeekPBO));
 }
 
 void Renderer::Shutdown()
@@ -942,6 +959,107 @@ void Renderer::UpdateEFBCache(EFBAccessType type, u32 cacheRectIdx, const EFBRec
 	s_efbCacheIsCleared = false;
 }
 
+// Starts reading back the whole EFB without waiting for the GPU.
+static void QueueEFBPeekReadback(u32 cacheType)
+{
+	EFBRectangle efbPixelRc(0, 0, EFB_WIDTH, EFB_HEIGHT);
+	TargetRectangle targetPixelRc = g_renderer->ConvertEFBRectangle(efbPixelRc);
+	u32 targetPixelRcWidth = targetPixelRc.right - targetPixelRc.left;
+	u32 targetPixelRcHeight = targetPixelRc.top - targetPixelRc.bottom;
+
+	if (s_MSAASamples > 1)
+	{
+		g_renderer->ResetAPIState();
+
+		if (cacheType == 0)
+			FramebufferManager::GetEFBDepthTexture(efbPixelRc);
+		else
+			FramebufferManager::GetEFBColorTexture(efbPixelRc);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, FramebufferManager::GetResolvedFramebuffer());
+
+		g_renderer->RestoreAPIState();
+	}
+
+	if (!s_efbPeekPBO[cacheType])
+		glGenBuffers(1, &s_efbPeekPBO[cacheType]);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, s_efbPeekPBO[cacheType]);
+	glBufferData(GL_PIXEL_PACK_BUFFER, targetPixelRcWidth * targetPixelRcHeight * sizeof(u32), nullptr, GL_STREAM_READ);
+
+	if (cacheType == 0)
+		glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
+		             GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+	else if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGLES3)
+		glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
+		             GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	else
+		glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
+		             GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	s_efbPeekFence[cacheType] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	s_efbPeekTargetRc[cacheType] = targetPixelRc;
+	s_efbPeekPending[cacheType] = true;
+}
+
+// Downsamples a finished readback to EFB resolution, the same way UpdateEFBCache does.
+static void FetchEFBPeekReadback(u32 cacheType)
+{
+	if (!s_efbPeekPending[cacheType])
+		return;
+
+	glClientWaitSync(s_efbPeekFence[cacheType], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+	glDeleteSync(s_efbPeekFence[cacheType]);
+	s_efbPeekPending[cacheType] = false;
+
+	const TargetRectangle& targetPixelRc = s_efbPeekTargetRc[cacheType];
+	u32 targetPixelRcWidth = targetPixelRc.right - targetPixelRc.left;
+	u32 targetPixelRcHeight = targetPixelRc.top - targetPixelRc.bottom;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, s_efbPeekPBO[cacheType]);
+	const u32* data = (const u32*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+		targetPixelRcWidth * targetPixelRcHeight * sizeof(u32), GL_MAP_READ_BIT);
+
+	if (data)
+	{
+		s_efbPeekData[cacheType].resize(EFB_WIDTH * EFB_HEIGHT);
+		for (u32 yEFB = 0; yEFB < EFB_HEIGHT; ++yEFB)
+		{
+			u32 yPixel = (Renderer::EFBToScaledY(EFB_HEIGHT - yEFB) + Renderer::EFBToScaledY(EFB_HEIGHT - yEFB - 1)) / 2;
+			u32 yData = std::min(yPixel - targetPixelRc.bottom, targetPixelRcHeight - 1);
+
+			for (u32 xEFB = 0; xEFB < EFB_WIDTH; ++xEFB)
+			{
+				u32 xPixel = (Renderer::EFBToScaledX(xEFB) + Renderer::EFBToScaledX(xEFB + 1)) / 2;
+				u32 xData = std::min(xPixel - targetPixelRc.left, targetPixelRcWidth - 1);
+				s_efbPeekData[cacheType][yEFB * EFB_WIDTH + xEFB] = data[yData * targetPixelRcWidth + xData];
+			}
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	else
+	{
+		s_efbPeekData[cacheType].clear();
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// Returns the value of the previous frame if there is one.
+static bool PeekEFBAsync(u32 cacheType, u32 x, u32 y, u32* value)
+{
+	if (!s_efbPeekPending[cacheType])
+		QueueEFBPeekReadback(cacheType);
+
+	if (s_efbPeekData[cacheType].empty())
+		return false;
+
+	*value = s_efbPeekData[cacheType][y * EFB_WIDTH + x];
+	INCSTAT(stats.thisFrame.numEFBPeeksAsync);
+	return true;
+}
+
 // This function allows the CPU to directly access the EFB.
 // There are EFB peeks (which will read the color or depth of a pixel)
 // and EFB pokes (which will change the color or depth of a pixel).
@@ -990,32 +1108,36 @@ u32 Renderer::AccessEFB(EFBAccessType type, u32 x, u32 y, u32 poke_data)
 		{
 			u32 z;
 
-			if (!s_efbCacheValid[0][cacheRectIdx])
+			INCSTAT(stats.thisFrame.numEFBPeeks);
+			if (!g_ActiveConfig.bEFBAccessAsync || !PeekEFBAsync(0, x, y, &z))
 			{
-				if (s_MSAASamples > 1)
+				if (!s_efbCacheValid[0][cacheRectIdx])
 				{
-					g_renderer->ResetAPIState();
+					if (s_MSAASamples > 1)
+					{
+						g_renderer->ResetAPIState();
 
-					// Resolve our rectangle.
-					FramebufferManager::GetEFBDepthTexture(efbPixelRc);
-					glBindFramebuffer(GL_READ_FRAMEBUFFER, FramebufferManager::GetResolvedFramebuffer());
+						// Resolve our rectangle.
+						FramebufferManager::GetEFBDepthTexture(efbPixelRc);
+						glBindFramebuffer(GL_READ_FRAMEBUFFER, FramebufferManager::GetResolvedFramebuffer());
 
-					g_renderer->RestoreAPIState();
-				}
+						g_renderer->RestoreAPIState();
+					}
 
-				u32* depthMap = new u32[targetPixelRcWidth * targetPixelRcHeight];
+					u32* depthMap = new u32[targetPixelRcWidth * targetPixelRcHeight];
 
-				glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
-				             GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, depthMap);
+					glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
+					             GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, depthMap);
 
-				UpdateEFBCache(type, cacheRectIdx, efbPixelRc, targetPixelRc, depthMap);
+					UpdateEFBCache(type, cacheRectIdx, efbPixelRc, targetPixelRc, depthMap);
 
-				delete[] depthMap;
-			}
+					delete[] depthMap;
+				}
 
-			u32 xRect = x % EFB_CACHE_RECT_SIZE;
-			u32 yRect = y % EFB_CACHE_RECT_SIZE;
-			z = s_efbCache[0][cacheRectIdx][yRect * EFB_CACHE_RECT_SIZE + xRect];
+				u32 xRect = x % EFB_CACHE_RECT_SIZE;
+				u32 yRect = y % EFB_CACHE_RECT_SIZE;
+				z = s_efbCache[0][cacheRectIdx][yRect * EFB_CACHE_RECT_SIZE + xRect];
+			}
 
 			// Scale the 32-bit value returned by glReadPixels to a 24-bit
 			// value (GC uses a 24-bit Z-buffer).
@@ -1042,37 +1164,41 @@ u32 Renderer::AccessEFB(EFBAccessType type, u32 x, u32 y, u32 poke_data)
 
 			u32 color;
 
-			if (!s_efbCacheValid[1][cacheRectIdx])
+			INCSTAT(stats.thisFrame.numEFBPeeks);
+			if (!g_ActiveConfig.bEFBAccessAsync || !PeekEFBAsync(1, x, y, &color))
 			{
-				if (s_MSAASamples > 1)
+				if (!s_efbCacheValid[1][cacheRectIdx])
 				{
-					g_renderer->ResetAPIState();
+					if (s_MSAASamples > 1)
+					{
+						g_renderer->ResetAPIState();
 
-					// Resolve our rectangle.
-					FramebufferManager::GetEFBColorTexture(efbPixelRc);
-					glBindFramebuffer(GL_READ_FRAMEBUFFER, FramebufferManager::GetResolvedFramebuffer());
+						// Resolve our rectangle.
+						FramebufferManager::GetEFBColorTexture(efbPixelRc);
+						glBindFramebuffer(GL_READ_FRAMEBUFFER, FramebufferManager::GetResolvedFramebuffer());
 
-					g_renderer->RestoreAPIState();
-				}
+						g_renderer->RestoreAPIState();
+					}
 
-				u32* colorMap = new u32[targetPixelRcWidth * targetPixelRcHeight];
+					u32* colorMap = new u32[targetPixelRcWidth * targetPixelRcHeight];
 
-				if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGLES3)
-				// XXX: Swap colours
-					glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
-						     GL_RGBA, GL_UNSIGNED_BYTE, colorMap);
-				else
-					glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
-						     GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, colorMap);
+					if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGLES3)
+					// XXX: Swap colours
+						glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
+							     GL_RGBA, GL_UNSIGNED_BYTE, colorMap);
+					else
+						glReadPixels(targetPixelRc.left, targetPixelRc.bottom, targetPixelRcWidth, targetPixelRcHeight,
+							     GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, colorMap);
 
-				UpdateEFBCache(type, cacheRectIdx, efbPixelRc, targetPixelRc, colorMap);
+					UpdateEFBCache(type, cacheRectIdx, efbPixelRc, targetPixelRc, colorMap);
 
-				delete[] colorMap;
-			}
+					delete[] colorMap;
+				}
 
-			u32 xRect = x % EFB_CACHE_RECT_SIZE;
-			u32 yRect = y % EFB_CACHE_RECT_SIZE;
-			color = s_efbCache[1][cacheRectIdx][yRect * EFB_CACHE_RECT_SIZE + xRect];
+				u32 xRect = x % EFB_CACHE_RECT_SIZE;
+				u32 yRect = y % EFB_CACHE_RECT_SIZE;
+				color = s_efbCache[1][cacheRectIdx][yRect * EFB_CACHE_RECT_SIZE + xRect];
+			}
 
 			// check what to do with the alpha channel (GX_PokeAlphaRead)
 			PixelEngine::UPEAlphaReadReg alpha_read_mode = PixelEngine::GetAlphaReadMode();
@@ -1437,6 +1563,13 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, co
 			glDisable(GL_DEBUG_OUTPUT);
 	}
 
+	// Peeks of the next frame are served from the readbacks queued during this one.
+	FetchEFBPeekReadback(0);
+	FetchEFBPeekReadback(1);
+
+	// Don't let deferred EFB copies wait for longer than a frame.
+	g_texture_cache->FlushEFBCopies();
+
 	static int w = 0, h = 0;
 	if (g_bSkipCurrentFrame || (!XFBWrited && !g_ActiveConfig.RealXFBEnabled()) || !fbWidth || !fbHeight)
 	{
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "Common/MemoryUtil.h"
+#include "Common/Timer.h"
 
 #include "VideoBackends/OGL/GLUtil.h"
 #include "VideoBackends/OGL/Render.h"
@@ -10,6 +11,7 @@
 
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/Statistics.h"
 
 namespace OGL
 {
@@ -77,6 +79,21 @@ void StreamBuffer::DeleteFences()
 		glDeleteSync(fences[i]);
 	}
 }
+
+// Polls the fence first, so only real waits on the GPU show up as stalls.
+void StreamBuffer::WaitForFence(int slot)
+{
+	GLenum result = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		u64 start = Common::Timer::GetTimeUs();
+		glClientWaitSync(fences[slot], 0, GL_TIMEOUT_IGNORED);
+		INCSTAT(stats.thisFrame.numStreamBufferStalls);
+		ADDSTAT(stats.thisFrame.streamBufferStallTimeUs, Common::Timer::GetTimeUs() - start);
+	}
+	glDeleteSync(fences[slot]);
+}
+
 void StreamBuffer::AllocMemory(u32 size)
 {
 	// insert waiting slots for used memory
@@ -89,8 +106,7 @@ void StreamBuffer::AllocMemory(u32 size)
 	// wait for new slots to end of buffer
 	for (int i = SLOT(m_free_iterator) + 1; i <= SLOT(m_iterator + size) && i < SYNC_POINTS; i++)
 	{
-		glClientWaitSync(fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
-		glDeleteSync(fences[i]);
+		WaitForFence(i);
 	}
 	m_free_iterator = m_iterator + size;
 
@@ -109,8 +125,7 @@ void StreamBuffer::AllocMemory(u32 size)
 		// wait for space at the start
 		for (int i = 0; i <= SLOT(m_iterator + size); i++)
 		{
-			glClientWaitSync(fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
-			glDeleteSync(fences[i]);
+			WaitForFence(i);
 		}
 		m_free_iterator = m_iterator + size;
 	}
@@ -216,12 +231,11 @@ public:
 		glBindBuffer(m_buffertype, m_buffer);
 
 		// PERSISTANT_BIT to make sure that the buffer can be used while mapped
-		// COHERENT_BIT is set so we don't have to use a MemoryBarrier on write
-		// CLIENT_STORAGE_BIT is set since we access the buffer more frequently on the client side then server side
+		// COHERENT_BIT is set so we neither have to flush the written range nor use a MemoryBarrier on write
 		glBufferStorage(m_buffertype, m_size, nullptr,
-			GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
+			GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
 		m_pointer = (u8*)glMapBufferRange(m_buffertype, 0, m_size,
-			GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+			GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
 	}
 
 	~BufferStorage()
@@ -239,7 +253,6 @@ public:
 
 	void Unmap(u32 used_size) override
 	{
-		glFlushMappedBufferRange(m_buffertype, m_iterator, used_size);
 		m_iterator += used_size;
 	}
 
@@ -47,6 +47,7 @@ protected:
 	void CreateFences();
 	void DeleteFences();
 	void AllocMemory(u32 size);
+	void WaitForFence(int slot);
 
 	const u32 m_buffertype;
 	const u32 m_size;
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <cmath>
+#include <deque>
 #include <fstream>
 #include <vector>
 
@@ -47,6 +48,18 @@ static u32 s_DepthCbufid;
 static u32 s_Textures[8];
 static u32 s_ActiveTexture;
 
+// EFB copies to RAM which are still being read back, in the order they were made.
+struct PendingEFBCopy
+{
+	TextureConverter::PendingEncode encode;
+	TextureCache::TCacheEntryBase* entry;
+	u32 address;
+	u32 size;
+	// The range written to RAM, which is larger than the texture if the rows are spread out.
+	u32 written_size;
+};
+static std::deque<PendingEFBCopy> s_pending_efb_copies;
+
 bool SaveTexture(const std::string& filename, u32 textarget, u32 tex, int virtual_width, int virtual_height, unsigned int level)
 {
 	if (GLInterface->GetMode() != GLInterfaceMode::MODE_OPENGL)
@@ -65,6 +78,10 @@ bool SaveTexture(const std::string& filename, u32 textarget, u32 tex, int virtua
 
 TextureCache::TCacheEntry::~TCacheEntry()
 {
+	for (auto& copy : s_pending_efb_copies)
+		if (copy.entry == this)
+			copy.entry = nullptr;
+
 	if (texture)
 	{
 		for (auto& gtex : s_Textures)
@@ -201,7 +218,34 @@ void TextureCache::TCacheEntry::FromRenderTarget(u32 dstAddr, unsigned int dstFo
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-	if (false == g_ActiveConfig.bCopyEFBToTexture)
+	if (false == g_ActiveConfig.bCopyEFBToTexture && g_ActiveConfig.bDeferEFBCopies)
+	{
+		PendingEFBCopy copy;
+		copy.size = TextureConverter::EncodeToRamFromTexture(
+			dstAddr,
+			read_texture,
+			srcFormat == PEControl::Z24,
+			isIntensity,
+			dstFormat,
+			scaleByHalf,
+			srcRect,
+			&copy.encode);
+		copy.entry = this;
+		copy.address = dstAddr;
+		if (copy.encode.write_stride != copy.encode.read_stride && copy.encode.read_loops > 1)
+			copy.written_size = (copy.encode.read_loops - 1) * copy.encode.write_stride + copy.encode.read_stride;
+		else
+			copy.written_size = copy.encode.dst_size;
+
+		// The hash is set once the data has arrived in RAM.
+		size_in_bytes = copy.size;
+
+		TextureCache::MakeRangeDynamic(dstAddr, copy.size);
+
+		s_pending_efb_copies.push_back(copy);
+		INCSTAT(stats.thisFrame.numEFBCopiesDeferred);
+	}
+	else if (false == g_ActiveConfig.bCopyEFBToTexture)
 	{
 		int encoded_size = TextureConverter::EncodeToRamFromTexture(
 			dstAddr,
@@ -246,9 +290,52 @@ TextureCache::TextureCache()
 
 TextureCache::~TextureCache()
 {
+	DiscardEFBCopies();
 	DeleteShaders();
 }
 
+static void FinishPendingEFBCopy(PendingEFBCopy& copy)
+{
+	TextureConverter::FinishEncode(&copy.encode);
+
+	// Using the copy as a texture compares this hash with the one of the RAM contents.
+	// The entry may have been reused for another copy in the meantime.
+	if (copy.entry && copy.entry->IsEfbCopy() && copy.entry->addr == copy.address)
+		copy.entry->hash = GetHash64(Memory::GetPointer(copy.address), copy.size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+}
+
+void TextureCache::FlushEFBCopies()
+{
+	for (auto& copy : s_pending_efb_copies)
+		FinishPendingEFBCopy(copy);
+	s_pending_efb_copies.clear();
+}
+
+void TextureCache::DiscardEFBCopies()
+{
+	for (auto& copy : s_pending_efb_copies)
+		TextureConverter::DiscardEncode(&copy.encode);
+	s_pending_efb_copies.clear();
+}
+
+void TextureCache::FlushEFBCopiesInRange(u32 address, u32 size)
+{
+	// Copies have to arrive in order, so flush everything up to the last overlapping one.
+	size_t count = 0;
+	for (size_t i = 0; i < s_pending_efb_copies.size(); ++i)
+	{
+		const PendingEFBCopy& copy = s_pending_efb_copies[i];
+		if (copy.address < address + size && address < copy.address + copy.written_size)
+			count = i + 1;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		FinishPendingEFBCopy(s_pending_efb_copies.front());
+		s_pending_efb_copies.pop_front();
+	}
+}
+
 void TextureCache::DisableStage(unsigned int stage)
 {
 }
@@ -21,6 +21,10 @@ public:
 	static void DisableStage(unsigned int stage);
 	static void SetStage();
 
+	void FlushEFBCopies() override;
+	void FlushEFBCopiesInRange(u32 address, u32 size) override;
+	void DiscardEFBCopies() override;
+
 private:
 	struct TCacheEntry : TCacheEntryBase
 	{
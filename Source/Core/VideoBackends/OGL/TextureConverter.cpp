@@ -214,7 +214,7 @@ void Shutdown()
 
 static void EncodeToRamUsingShader(GLuint srcTexture,
 						u8* destAddr, int dstWidth, int dstHeight, int readStride,
-						bool linearFilter)
+						bool linearFilter, PendingEncode* pending = nullptr)
 {
 
 
@@ -251,7 +251,24 @@ static void EncodeToRamUsingShader(GLuint srcTexture,
 	int readHeight = readStride / dstWidth / 4; // 4 bytes per pixel
 	int readLoops = dstHeight / readHeight;
 
-	if (writeStride != readStride && readLoops > 1)
+	if (pending)
+	{
+		// read back into a PBO of its own, FinishEncode copies it to GC memory later
+		pending->dest = destAddr;
+		pending->dst_size = dstSize;
+		pending->read_stride = readStride;
+		pending->write_stride = writeStride;
+		pending->read_loops = readLoops;
+
+		glGenBuffers(1, &pending->pbo);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pending->pbo);
+		glBufferData(GL_PIXEL_PACK_BUFFER, dstSize, nullptr, GL_STREAM_READ);
+		glReadPixels(0, 0, (GLsizei)dstWidth, (GLsizei)dstHeight, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		pending->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	else if (writeStride != readStride && readLoops > 1)
 	{
 		// writing to a texture of a different size
 		// also copy more then one block line, so the different strides matters
@@ -279,7 +296,8 @@ static void EncodeToRamUsingShader(GLuint srcTexture,
 	}
 }
 
-int EncodeToRamFromTexture(u32 address,GLuint source_texture, bool bFromZBuffer, bool bIsIntensityFmt, u32 copyfmt, int bScaleByHalf, const EFBRectangle& source)
+int EncodeToRamFromTexture(u32 address,GLuint source_texture, bool bFromZBuffer, bool bIsIntensityFmt, u32 copyfmt, int bScaleByHalf, const EFBRectangle& source,
+                           PendingEncode* pending)
 {
 	u32 format = copyfmt;
 
@@ -329,11 +347,49 @@ int EncodeToRamFromTexture(u32 address,GLuint source_texture, bool bFromZBuffer,
 
 	EncodeToRamUsingShader(source_texture,
 		dest_ptr, cacheLinesPerRow * 8, numBlocksY, cacheLinesPerRow * 32,
-		bScaleByHalf > 0 && !bFromZBuffer);
+		bScaleByHalf > 0 && !bFromZBuffer, pending);
 	return size_in_bytes; // TODO: D3D11 is calculating this value differently!
 
 }
 
+void FinishEncode(PendingEncode* pending)
+{
+	glClientWaitSync(pending->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+	glDeleteSync(pending->fence);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pending->pbo);
+	u8* pbo = (u8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pending->dst_size, GL_MAP_READ_BIT);
+	if (pbo)
+	{
+		u8* destAddr = pending->dest;
+		if (pending->write_stride != pending->read_stride && pending->read_loops > 1)
+		{
+			for (int i = 0; i < pending->read_loops; i++)
+			{
+				memcpy(destAddr, pbo, pending->read_stride);
+				pbo += pending->read_stride;
+				destAddr += pending->write_stride;
+			}
+		}
+		else
+		{
+			memcpy(destAddr, pbo, pending->dst_size);
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	glDeleteBuffers(1, &pending->pbo);
+	pending->pbo = 0;
+}
+
+void DiscardEncode(PendingEncode* pending)
+{
+	glDeleteSync(pending->fence);
+	glDeleteBuffers(1, &pending->pbo);
+	pending->pbo = 0;
+}
+
 void EncodeToRamYUYV(GLuint srcTexture, const TargetRectangle& sourceRc, u8* destAddr, int dstWidth, int dstHeight)
 {
 	g_renderer->ResetAPIState();
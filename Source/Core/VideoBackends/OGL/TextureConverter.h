@@ -15,6 +15,18 @@ namespace OGL
 namespace TextureConverter
 {
 
+// An EFB copy which has been encoded on the GPU, but not yet written to RAM.
+struct PendingEncode
+{
+	u8* dest;
+	int dst_size;
+	int read_stride;
+	int write_stride;
+	int read_loops;
+	GLuint pbo;
+	GLsync fence;
+};
+
 void Init();
 void Shutdown();
 
@@ -24,7 +36,12 @@ void EncodeToRamYUYV(GLuint srcTexture, const TargetRectangle& sourceRc,
 void DecodeToTexture(u32 xfbAddr, int srcWidth, int srcHeight, GLuint destTexture);
 
 // returns size of the encoded data (in bytes)
-int EncodeToRamFromTexture(u32 address, GLuint source_texture, bool bFromZBuffer, bool bIsIntensityFmt, u32 copyfmt, int bScaleByHalf, const EFBRectangle& source);
+// If pending is given, the data is only read back into a PBO and written to RAM by FinishEncode.
+int EncodeToRamFromTexture(u32 address, GLuint source_texture, bool bFromZBuffer, bool bIsIntensityFmt, u32 copyfmt, int bScaleByHalf, const EFBRectangle& source,
+                           PendingEncode* pending = nullptr);
+
+void FinishEncode(PendingEncode* pending);
+void DiscardEncode(PendingEncode* pending);
 
 }
 
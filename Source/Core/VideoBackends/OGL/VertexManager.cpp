@@ -157,15 +157,21 @@ void VertexManager::vFlush(bool useDstAlpha)
 
 	// If host supports GL_ARB_blend_func_extended, we can do dst alpha in
 	// the same pass as regular rendering.
+	SHADER* shader;
 	if (useDstAlpha && dualSourcePossible)
 	{
-		ProgramShaderCache::SetShader(DSTALPHA_DUAL_SOURCE_BLEND, nativeVertexFmt->m_components, current_primitive_type);
+		shader = ProgramShaderCache::SetShader(DSTALPHA_DUAL_SOURCE_BLEND, nativeVertexFmt->m_components, current_primitive_type);
 	}
 	else
 	{
-		ProgramShaderCache::SetShader(DSTALPHA_NONE, nativeVertexFmt->m_components, current_primitive_type);
+		shader = ProgramShaderCache::SetShader(DSTALPHA_NONE, nativeVertexFmt->m_components, current_primitive_type);
 	}
 
+	// The program is either still being compiled asynchronously or failed to
+	// compile, so there is nothing sensible to draw with.
+	if (!shader)
+		return;
+
 	// upload global constants
 	ProgramShaderCache::UploadConstants();
 
@@ -175,10 +181,9 @@ void VertexManager::vFlush(bool useDstAlpha)
 	Draw(stride);
 
 	// run through vertex groups again to set alpha
-	if (useDstAlpha && !dualSourcePossible)
+	if (useDstAlpha && !dualSourcePossible &&
+	    ProgramShaderCache::SetShader(DSTALPHA_ALPHA_PASS, nativeVertexFmt->m_components, current_primitive_type))
 	{
-		ProgramShaderCache::SetShader(DSTALPHA_ALPHA_PASS, nativeVertexFmt->m_components, current_primitive_type);
-
 		// only update alpha
 		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
 
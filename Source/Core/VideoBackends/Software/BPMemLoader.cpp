@@ -24,6 +24,34 @@ void InitBPMemory()
 	bpmem.bpMask = 0xFFFFFF;
 }
 
+static bool IsTriggerRegister(int address)
+{
+	switch (address)
+	{
+	case BPMEM_SETDRAWDONE:
+	case BPMEM_PE_TOKEN_ID:
+	case BPMEM_PE_TOKEN_INT_ID:
+	case BPMEM_TRIGGER_EFB_COPY:
+	case BPMEM_CLEARBBOX1:
+	case BPMEM_CLEARBBOX2:
+	case BPMEM_CLEAR_PIXEL_PERF:
+	case BPMEM_LOADTLUT1:
+	case BPMEM_PRELOAD_MODE:
+	case BPMEM_TEXINVALIDATE:
+	case BPMEM_TEV_COLOR_RA:
+	case BPMEM_TEV_COLOR_RA + 2:
+	case BPMEM_TEV_COLOR_RA + 4:
+	case BPMEM_TEV_COLOR_RA + 6:
+	case BPMEM_TEV_COLOR_BG:
+	case BPMEM_TEV_COLOR_BG + 2:
+	case BPMEM_TEV_COLOR_BG + 4:
+	case BPMEM_TEV_COLOR_BG + 6:
+		return true;
+	default:
+		return false;
+	}
+}
+
 void SWLoadBPReg(u32 value)
 {
 	//handle the mask register
@@ -31,6 +59,11 @@ void SWLoadBPReg(u32 value)
 	int oldval = ((u32*)&bpmem)[address];
 	int newval = (oldval & ~bpmem.bpMask) | (value & bpmem.bpMask);
 
+	// Pending triangles are shaded with the current state. Rewriting a register with
+	// its old value is common and harmless, unless the write triggers something.
+	if (newval != oldval || IsTriggerRegister(address))
+		Rasterizer::Flush();
+
 	((u32*)&bpmem)[address] = newval;
 
 	//reset the mask register
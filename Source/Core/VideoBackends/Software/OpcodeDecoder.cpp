@@ -2,6 +2,8 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Core/HW/Memmap.h"
@@ -64,12 +66,12 @@ static void DecodePrimitiveStream(u32 iBufferSize)
 	}
 	else
 	{
-		while (streamSize > 0 && iBufferSize >= vertexSize)
-		{
-			vertexLoader.LoadVertex();
-			iBufferSize -= vertexSize;
-			streamSize--;
-		}
+		u32 count = streamSize;
+		if (vertexSize > 0)
+			count = std::min(count, iBufferSize / vertexSize);
+
+		vertexLoader.LoadVertices(count);
+		streamSize -= (u16)count;
 	}
 
 	if (streamSize == 0)
@@ -3,8 +3,16 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Common/Thread.h"
 #include "VideoBackends/Software/BPMemLoader.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/HwRasterizer.h"
@@ -13,12 +21,23 @@
 #include "VideoBackends/Software/SWStatistics.h"
 #include "VideoBackends/Software/SWVideoConfig.h"
 #include "VideoBackends/Software/Tev.h"
+#include "VideoBackends/Software/TextureSampler.h"
 #include "VideoBackends/Software/XFMemLoader.h"
 #include "VideoCommon/BoundingBox.h"
 
 
 #define BLOCK_SIZE 2
 
+// Triangles are binned into screen tiles which the rasterizer threads draw independently.
+// Tiles are aligned to blocks, so every block is drawn by exactly one thread.
+static const int TILE_SIZE = 32;
+static const int TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static const int TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+static const int NUM_TILES = TILES_X * TILES_Y;
+
+static const size_t MAX_BATCH_TRIANGLES = 4096;
+static const int MAX_RASTERIZER_THREADS = 16;
+
 #define CLAMP(x, a, b) (x>b)?b:(x<a)?a:x
 
 // returns approximation of log2(f) in s28.4
@@ -34,54 +53,188 @@ static inline s32 FixedLog2(float f)
 
 namespace Rasterizer
 {
-static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
+struct TriangleSetup
+{
+	Slope ZSlope;
+	Slope WSlope;
+	Slope ColorSlopes[2][4];
+	Slope TexSlopes[8][3];
+
+	s32 vertex0X;
+	s32 vertex0Y;
+	float vertexOffsetX;
+	float vertexOffsetY;
+
+	// 28.4 fixed-point deltas and half-edge constants
+	s32 DX12, DX23, DX31;
+	s32 DY12, DY23, DY31;
+	s32 C1, C2, C3;
+
+	// scissored bounding rectangle
+	s32 minx, maxx, miny, maxy;
+};
+
+struct RasterContext
+{
+	const TriangleSetup* setup;
+	Tev tev;
+	RasterBlock rasterBlock;
+	Tev::Counters counters;
+};
 
-static s32 vertex0X;
-static s32 vertex0Y;
-static float vertexOffsetX;
-static float vertexOffsetY;
+// The most recently set up triangle. Its ZSlope is kept for the following triangles while zfreeze is enabled.
+static TriangleSetup setup;
 
 static s32 scissorLeft = 0;
 static s32 scissorTop = 0;
 static s32 scissorRight = 0;
 static s32 scissorBottom = 0;
 
-static Tev tev;
-static RasterBlock rasterBlock;
+// Draws on the GPU thread. Its TEV holds the color registers set by the game.
+static RasterContext context;
+
+// Triangles waiting to be drawn by the rasterizer threads, in submission order
+struct RasterBatch
+{
+	std::vector<TriangleSetup> triangles;
+	std::vector<u32> bins[NUM_TILES];
+};
+
+// While the rasterizer threads draw one batch, the GPU thread keeps transforming vertices
+// and fills the other one.
+static RasterBatch s_batches[2];
+static RasterBatch* s_current_batch = &s_batches[0];
+static RasterBatch* s_raster_batch = nullptr;
+
+// The first context is used by the GPU thread while it helps drawing the tiles.
+static std::vector<std::unique_ptr<RasterContext>> s_tile_contexts;
+static std::vector<std::thread> s_raster_threads;
+static std::mutex s_raster_mutex;
+static std::condition_variable s_raster_cv;
+static std::condition_variable s_raster_done_cv;
+static std::atomic<int> s_next_tile;
+static std::atomic<int> s_remaining_tiles;
+static u32 s_raster_generation;
+static int s_raster_busy_threads;
+static bool s_raster_threads_running;
 
 void DoState(PointerWrap &p)
 {
-	ZSlope.DoState(p);
-	WSlope.DoState(p);
-	for (auto& color_slopes_1d : ColorSlopes)
+	Flush();
+
+	setup.ZSlope.DoState(p);
+	setup.WSlope.DoState(p);
+	for (auto& color_slopes_1d : setup.ColorSlopes)
 		for (Slope& color_slope : color_slopes_1d)
 			color_slope.DoState(p);
-	for (auto& tex_slopes_1d : TexSlopes)
+	for (auto& tex_slopes_1d : setup.TexSlopes)
 		for (Slope& tex_slope : tex_slopes_1d)
 			tex_slope.DoState(p);
-	p.Do(vertex0X);
-	p.Do(vertex0Y);
-	p.Do(vertexOffsetX);
-	p.Do(vertexOffsetY);
+	p.Do(setup.vertex0X);
+	p.Do(setup.vertex0Y);
+	p.Do(setup.vertexOffsetX);
+	p.Do(setup.vertexOffsetY);
 	p.Do(scissorLeft);
 	p.Do(scissorTop);
 	p.Do(scissorRight);
 	p.Do(scissorBottom);
-	tev.DoState(p);
-	p.Do(rasterBlock);
+	context.tev.DoState(p);
+	p.Do(context.rasterBlock);
+}
+
+static void RasterizeTiles(RasterContext& tile_context, const RasterBatch& batch);
+
+static void RasterThread(RasterContext* tile_context)
+{
+	Common::SetCurrentThreadName("Rasterizer");
+
+	u32 generation = 0;
+	while (true)
+	{
+		const RasterBatch* batch;
+		{
+			std::unique_lock<std::mutex> lk(s_raster_mutex);
+			s_raster_cv.wait(lk, [&] { return !s_raster_threads_running || s_raster_generation != generation; });
+			if (!s_raster_threads_running)
+				return;
+			generation = s_raster_generation;
+			batch = s_raster_batch;
+			if (!batch)
+				continue;
+			s_raster_busy_threads++;
+		}
+
+		RasterizeTiles(*tile_context, *batch);
+
+		std::lock_guard<std::mutex> lk(s_raster_mutex);
+		if (--s_raster_busy_threads == 0)
+			s_raster_done_cv.notify_all();
+	}
+}
+
+static void StartRasterThreads()
+{
+	if (!g_SWVideoConfig.bThreadedRasterizer)
+		return;
+
+	int num_threads = std::min(cpu_info.num_cores - 1, MAX_RASTERIZER_THREADS - 1);
+	if (num_threads <= 0)
+		return;
+
+	for (int i = 0; i <= num_threads; i++)
+	{
+		s_tile_contexts.emplace_back(new RasterContext);
+		RasterContext& tile_context = *s_tile_contexts.back();
+		tile_context.tev.Init();
+		tile_context.counters.Reset();
+		tile_context.tev.m_counters = &tile_context.counters;
+	}
+
+	s_raster_threads_running = true;
+	for (int i = 0; i < num_threads; i++)
+		s_raster_threads.emplace_back(RasterThread, s_tile_contexts[i + 1].get());
+}
+
+static void WaitForRasterBatch();
+
+static void StopRasterThreads()
+{
+	WaitForRasterBatch();
+
+	{
+		std::lock_guard<std::mutex> lk(s_raster_mutex);
+		s_raster_threads_running = false;
+	}
+	s_raster_cv.notify_all();
+
+	for (std::thread& thread : s_raster_threads)
+		thread.join();
+	s_raster_threads.clear();
+	s_tile_contexts.clear();
 }
 
 void Init()
 {
-	tev.Init();
+	context.tev.Init();
 
 	// Set initial z reference plane in the unlikely case that zfreeze is enabled when drawing the first primitive.
 	// TODO: This is just a guess!
-	ZSlope.dfdx = ZSlope.dfdy = 0.f;
-	ZSlope.f0 = 1.f;
+	setup.ZSlope.dfdx = setup.ZSlope.dfdy = 0.f;
+	setup.ZSlope.f0 = 1.f;
+
+	StartRasterThreads();
+}
+
+void Shutdown()
+{
+	StopRasterThreads();
+
+	for (RasterBatch& batch : s_batches)
+	{
+		batch.triangles.clear();
+		for (std::vector<u32>& bin : batch.bins)
+			bin.clear();
+	}
 }
 
 static inline int iround(float x)
@@ -117,31 +270,38 @@ void SetScissor()
 
 void SetTevReg(int reg, int comp, bool konst, s16 color)
 {
-	tev.SetRegColor(reg, comp, konst, color);
+	context.tev.SetRegColor(reg, comp, konst, color);
 }
 
-inline void Draw(s32 x, s32 y, s32 xi, s32 yi)
+static inline void Draw(RasterContext& ctx, s32 x, s32 y, s32 xi, s32 yi)
 {
-	INCSTAT(swstats.thisFrame.rasterizedPixels);
+	const TriangleSetup& tri = *ctx.setup;
+	Tev& tev = ctx.tev;
+	RasterBlock& rasterBlock = ctx.rasterBlock;
 
-	float dx = vertexOffsetX + (float)(x - vertex0X);
-	float dy = vertexOffsetY + (float)(y - vertex0Y);
+	if (tev.m_counters)
+		tev.m_counters->rasterized_pixels++;
+	else
+		INCSTAT(swstats.thisFrame.rasterizedPixels);
+
+	float dx = tri.vertexOffsetX + (float)(x - tri.vertex0X);
+	float dy = tri.vertexOffsetY + (float)(y - tri.vertex0Y);
 
-	s32 z = (s32)ZSlope.GetValue(dx, dy);
+	s32 z = (s32)tri.ZSlope.GetValue(dx, dy);
 	if (z < 0 || z > 0x00ffffff)
 		return;
 
 	if (!BoundingBox::active && bpmem.UseEarlyDepthTest() && g_SWVideoConfig.bZComploc)
 	{
 		// TODO: Test if perf regs are incremented even if test is disabled
-		EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
+		tev.IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
 		if (bpmem.zmode.testenable)
 		{
 			// early z
 			if (!EfbInterface::ZCompare(x, y, z))
 				return;
 		}
-		EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
+		tev.IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
 	}
 
 	RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
@@ -155,7 +315,7 @@ inline void Draw(s32 x, s32 y, s32 xi, s32 yi)
 	{
 		for (int comp = 0; comp < 4; comp++)
 		{
-			u16 color = (u16)ColorSlopes[i][comp].GetValue(dx, dy);
+			u16 color = (u16)tri.ColorSlopes[i][comp].GetValue(dx, dy);
 
 			// clamp color value to 0
 			u16 mask = ~(color >> 8);
@@ -187,16 +347,16 @@ inline void Draw(s32 x, s32 y, s32 xi, s32 yi)
 	tev.Draw();
 }
 
-static void InitTriangle(float X1, float Y1, s32 xi, s32 yi)
+static void InitTriangle(TriangleSetup& tri, float X1, float Y1, s32 xi, s32 yi)
 {
-	vertex0X = xi;
-	vertex0Y = yi;
+	tri.vertex0X = xi;
+	tri.vertex0Y = yi;
 
 	// adjust a little less than 0.5
 	const float adjust = 0.495f;
 
-	vertexOffsetX = ((float)xi - X1) + adjust;
-	vertexOffsetY = ((float)yi - Y1) + adjust;
+	tri.vertexOffsetX = ((float)xi - X1) + adjust;
+	tri.vertexOffsetY = ((float)yi - Y1) + adjust;
 }
 
 static void InitSlope(Slope *slope, float f1, float f2, float f3, float DX31, float DX12, float DY12, float DY31)
@@ -211,7 +371,7 @@ static void InitSlope(Slope *slope, float f1, float f2, float f3, float DX31, fl
 	slope->f0 = f1;
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear, u32 texmap, u32 texcoord)
 {
 	FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
 	u8 subTexmap = texmap & 3;
@@ -224,17 +384,17 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
 	float sDelta, tDelta;
 	if (tm0.diag_lod)
 	{
-		float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-		float *uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
+		const float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+		const float *uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
 
 		sDelta = fabsf(uv0[0] - uv1[0]);
 		tDelta = fabsf(uv0[1] - uv1[1]);
 	}
 	else
 	{
-		float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-		float *uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
-		float *uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
+		const float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+		const float *uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
+		const float *uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
 		sDelta = std::max(fabsf(uv0[0] - uv1[0]), fabsf(uv0[0] - uv2[0]));
 		tDelta = std::max(fabsf(uv0[1] - uv1[1]), fabsf(uv0[1] - uv2[1]));
@@ -258,18 +418,21 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
 	*lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(RasterContext& ctx, s32 blockX, s32 blockY)
 {
+	const TriangleSetup& tri = *ctx.setup;
+	RasterBlock& rasterBlock = ctx.rasterBlock;
+
 	for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
 	{
 		for (s32 xi = 0; xi < BLOCK_SIZE; xi++)
 		{
 			RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
-			float dx = vertexOffsetX + (float)(xi + blockX - vertex0X);
-			float dy = vertexOffsetY + (float)(yi + blockY - vertex0Y);
+			float dx = tri.vertexOffsetX + (float)(xi + blockX - tri.vertex0X);
+			float dy = tri.vertexOffsetY + (float)(yi + blockY - tri.vertex0Y);
 
-			float invW = 1.0f / WSlope.GetValue(dx, dy);
+			float invW = 1.0f / tri.WSlope.GetValue(dx, dy);
 			pixel.InvW = invW;
 
 			// tex coords
@@ -278,13 +441,13 @@ static void BuildBlock(s32 blockX, s32 blockY)
 				float projection = invW;
 				if (xfmem.texMtxInfo[i].projection)
 				{
-					float q = TexSlopes[i][2].GetValue(dx, dy) * invW;
+					float q = tri.TexSlopes[i][2].GetValue(dx, dy) * invW;
 					if (q != 0.0f)
 						projection = invW / q;
 				}
 
-				pixel.Uv[i][0] = TexSlopes[i][0].GetValue(dx, dy) * projection;
-				pixel.Uv[i][1] = TexSlopes[i][1].GetValue(dx, dy) * projection;
+				pixel.Uv[i][0] = tri.TexSlopes[i][0].GetValue(dx, dy) * projection;
+				pixel.Uv[i][1] = tri.TexSlopes[i][1].GetValue(dx, dy) * projection;
 			}
 		}
 	}
@@ -297,7 +460,7 @@ static void BuildBlock(s32 blockX, s32 blockY)
 		u32 texcoord = indref & 3;
 		indref >>= 3;
 
-		CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+		CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
 	}
 
 	for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -309,12 +472,12 @@ static void BuildBlock(s32 blockX, s32 blockY)
 			u32 texmap = order.getTexMap(stageOdd);
 			u32 texcoord = order.getTexCoord(stageOdd);
 
-			CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+			CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
 		}
 	}
 }
 
-static inline void PrepareBlock(s32 blockX, s32 blockY)
+static inline void PrepareBlock(RasterContext& ctx, s32 blockX, s32 blockY)
 {
 	static s32 x = -1;
 	static s32 y = -1;
@@ -326,8 +489,450 @@ static inline void PrepareBlock(s32 blockX, s32 blockY)
 	{
 		x = blockX;
 		y = blockY;
-		BuildBlock(x, y);
+		BuildBlock(ctx, x, y);
+	}
+}
+
+// Draws the part of the triangle inside the given rectangle
+static void RasterizeTriangle(RasterContext& ctx, const TriangleSetup& tri, s32 minx, s32 maxx, s32 miny, s32 maxy)
+{
+	ctx.setup = &tri;
+
+	const s32 DX12 = tri.DX12;
+	const s32 DX23 = tri.DX23;
+	const s32 DX31 = tri.DX31;
+
+	const s32 DY12 = tri.DY12;
+	const s32 DY23 = tri.DY23;
+	const s32 DY31 = tri.DY31;
+
+	const s32 FDX12 = DX12 << 4;
+	const s32 FDX23 = DX23 << 4;
+	const s32 FDX31 = DX31 << 4;
+
+	const s32 FDY12 = DY12 << 4;
+	const s32 FDY23 = DY23 << 4;
+	const s32 FDY31 = DY31 << 4;
+
+	const s32 C1 = tri.C1;
+	const s32 C2 = tri.C2;
+	const s32 C3 = tri.C3;
+
+	// Start in corner of 8x8 block
+	minx &= ~(BLOCK_SIZE - 1);
+	miny &= ~(BLOCK_SIZE - 1);
+
+	// Loop through blocks
+	for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
+	{
+		for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
+		{
+			// Corners of block
+			s32 x0 = x << 4;
+			s32 x1 = (x + BLOCK_SIZE - 1) << 4;
+			s32 y0 = y << 4;
+			s32 y1 = (y + BLOCK_SIZE - 1) << 4;
+
+			// Evaluate half-space functions
+			bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
+			bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
+			bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
+			bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
+			int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
+
+			bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
+			bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
+			bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
+			bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
+			int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
+
+			bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
+			bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
+			bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
+			bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
+			int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
+
+			// Skip block when outside an edge
+			if (a == 0x0 || b == 0x0 || c == 0x0)
+				continue;
+
+			BuildBlock(ctx, x, y);
+
+			// Accept whole block when totally covered
+			if (a == 0xF && b == 0xF && c == 0xF)
+			{
+				for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+				{
+					for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+					{
+						Draw(ctx, x + ix, y + iy, ix, iy);
+					}
+				}
+			}
+			else // Partially covered block
+			{
+				s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
+				s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
+				s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
+
+				for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+				{
+					s32 CX1 = CY1;
+					s32 CX2 = CY2;
+					s32 CX3 = CY3;
+
+					for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+					{
+						if (CX1 > 0 && CX2 > 0 && CX3 > 0)
+						{
+							Draw(ctx, x + ix, y + iy, ix, iy);
+						}
+
+						CX1 -= FDY12;
+						CX2 -= FDY23;
+						CX3 -= FDY31;
+					}
+
+					CY1 += FDX12;
+					CY2 += FDX23;
+					CY3 += FDX31;
+				}
+			}
+		}
+	}
+}
+
+static void CalculateBoundingBox(RasterContext& ctx, const TriangleSetup& tri)
+{
+	ctx.setup = &tri;
+
+	const s32 DX12 = tri.DX12;
+	const s32 DX23 = tri.DX23;
+	const s32 DX31 = tri.DX31;
+
+	const s32 DY12 = tri.DY12;
+	const s32 DY23 = tri.DY23;
+	const s32 DY31 = tri.DY31;
+
+	const s32 FDX12 = DX12 << 4;
+	const s32 FDX23 = DX23 << 4;
+	const s32 FDX31 = DX31 << 4;
+
+	const s32 FDY12 = DY12 << 4;
+	const s32 FDY23 = DY23 << 4;
+	const s32 FDY31 = DY31 << 4;
+
+	const s32 C1 = tri.C1;
+	const s32 C2 = tri.C2;
+	const s32 C3 = tri.C3;
+
+	s32 minx = tri.minx;
+	s32 maxx = tri.maxx;
+	s32 miny = tri.miny;
+	s32 maxy = tri.maxy;
+
+	// Calculating bbox
+	// First check for alpha channel - don't do anything it if always fails,
+	// Change bbox to primitive size if it always passes
+	AlphaTest::TEST_RESULT alphaRes = bpmem.alpha_test.TestResult();
+
+	if (alphaRes != AlphaTest::UNDETERMINED)
+	{
+		if (alphaRes == AlphaTest::PASS)
+		{
+			BoundingBox::coords[BoundingBox::TOP]    = std::min(BoundingBox::coords[BoundingBox::TOP],    (u16) miny);
+			BoundingBox::coords[BoundingBox::LEFT]   = std::min(BoundingBox::coords[BoundingBox::LEFT],   (u16) minx);
+			BoundingBox::coords[BoundingBox::BOTTOM] = std::max(BoundingBox::coords[BoundingBox::BOTTOM], (u16) maxy);
+			BoundingBox::coords[BoundingBox::RIGHT]  = std::max(BoundingBox::coords[BoundingBox::RIGHT],  (u16) maxx);
+		}
+		return;
+	}
+
+	// If we are calculating bbox with alpha, we only need to find the
+	// topmost, leftmost, bottom most and rightmost pixels to be drawn.
+	// So instead of drawing every single one of the triangle's pixels,
+	// four loops are run: one for the top pixel, one for the left, one for
+	// the bottom and one for the right. As soon as a pixel that is to be
+	// drawn is found, the loop breaks. This enables a ~150% speedbost in
+	// bbox calculation, albeit at the cost of some ugly repetitive code.
+	const s32 FLEFT   = minx << 4;
+	const s32 FRIGHT  = maxx << 4;
+	s32 FTOP    = miny << 4;
+	s32 FBOTTOM = maxy << 4;
+
+	// Start checking for bbox top
+	s32 CY1 = C1 + DX12 * FTOP - DY12 * FLEFT;
+	s32 CY2 = C2 + DX23 * FTOP - DY23 * FLEFT;
+	s32 CY3 = C3 + DX31 * FTOP - DY31 * FLEFT;
+
+	// Loop
+	for (s32 y = miny; y <= maxy; ++y)
+	{
+		if (y >= BoundingBox::coords[BoundingBox::TOP])
+			break;
+
+		s32 CX1 = CY1;
+		s32 CX2 = CY2;
+		s32 CX3 = CY3;
+
+		for (s32 x = minx; x <= maxx; ++x)
+		{
+			if (CX1 > 0 && CX2 > 0 && CX3 > 0)
+			{
+				// Build the new raster block every other pixel
+				PrepareBlock(ctx, x, y);
+				Draw(ctx, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+
+				if (y >= BoundingBox::coords[BoundingBox::TOP])
+					break;
+			}
+
+			CX1 -= FDY12;
+			CX2 -= FDY23;
+			CX3 -= FDY31;
+		}
+
+		CY1 += FDX12;
+		CY2 += FDX23;
+		CY3 += FDX31;
+	}
+
+	// Update top limit
+	miny = std::max((s32) BoundingBox::coords[BoundingBox::TOP], miny);
+	FTOP = miny << 4;
+
+	// Checking for bbox left
+	s32 CX1 = C1 + DX12 * FTOP - DY12 * FLEFT;
+	s32 CX2 = C2 + DX23 * FTOP - DY23 * FLEFT;
+	s32 CX3 = C3 + DX31 * FTOP - DY31 * FLEFT;
+
+	// Loop
+	for (s32 x = minx; x <= maxx; ++x)
+	{
+		if (x >= BoundingBox::coords[BoundingBox::LEFT])
+			break;
+
+		CY1 = CX1;
+		CY2 = CX2;
+		CY3 = CX3;
+
+		for (s32 y = miny; y <= maxy; ++y)
+		{
+			if (CY1 > 0 && CY2 > 0 && CY3 > 0)
+			{
+				PrepareBlock(ctx, x, y);
+				Draw(ctx, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+
+				if (x >= BoundingBox::coords[BoundingBox::LEFT])
+					break;
+			}
+
+			CY1 += FDX12;
+			CY2 += FDX23;
+			CY3 += FDX31;
+		}
+
+		CX1 -= FDY12;
+		CX2 -= FDY23;
+		CX3 -= FDY31;
+	}
+
+	// Update left limit
+	minx = std::max((s32) BoundingBox::coords[BoundingBox::LEFT], minx);
+
+	// Checking for bbox bottom
+	CY1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
+	CY2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
+	CY3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
+
+	// Loop
+	for (s32 y = maxy; y >= miny; --y)
+	{
+		CX1 = CY1;
+		CX2 = CY2;
+		CX3 = CY3;
+
+		if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
+			break;
+
+		for (s32 x = maxx; x >= minx; --x)
+		{
+			if (CX1 > 0 && CX2 > 0 && CX3 > 0)
+			{
+				// Build the new raster block every other pixel
+				PrepareBlock(ctx, x, y);
+				Draw(ctx, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+
+				if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
+					break;
+			}
+
+			CX1 += FDY12;
+			CX2 += FDY23;
+			CX3 += FDY31;
+		}
+
+		CY1 -= FDX12;
+		CY2 -= FDX23;
+		CY3 -= FDX31;
+	}
+
+	// Update bottom limit
+	maxy = std::min((s32) BoundingBox::coords[BoundingBox::BOTTOM], maxy);
+	FBOTTOM = maxy << 4;
+
+	// Checking for bbox right
+	CX1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
+	CX2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
+	CX3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
+
+	// Loop
+	for (s32 x = maxx; x >= minx; --x)
+	{
+		if (x <= BoundingBox::coords[BoundingBox::RIGHT])
+			break;
+
+		CY1 = CX1;
+		CY2 = CX2;
+		CY3 = CX3;
+
+		for (s32 y = maxy; y >= miny; --y)
+		{
+			if (CY1 > 0 && CY2 > 0 && CY3 > 0)
+			{
+				// Build the new raster block every other pixel
+				PrepareBlock(ctx, x, y);
+				Draw(ctx, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+
+				if (x <= BoundingBox::coords[BoundingBox::RIGHT])
+					break;
+			}
+
+			CY1 -= FDX12;
+			CY2 -= FDX23;
+			CY3 -= FDX31;
+		}
+
+		CX1 += FDY12;
+		CX2 += FDY23;
+		CX3 += FDY31;
+	}
+}
+
+static void KickRasterBatch();
+
+static void BinTriangle(const TriangleSetup& tri)
+{
+	RasterBatch& batch = *s_current_batch;
+	u32 index = (u32)batch.triangles.size();
+	batch.triangles.push_back(tri);
+
+	int left = tri.minx / TILE_SIZE;
+	int right = (tri.maxx - 1) / TILE_SIZE;
+	int top = tri.miny / TILE_SIZE;
+	int bottom = (tri.maxy - 1) / TILE_SIZE;
+
+	for (int y = top; y <= bottom; y++)
+	{
+		for (int x = left; x <= right; x++)
+			batch.bins[y * TILES_X + x].push_back(index);
+	}
+
+	// Full batches are drawn in the background, nothing the pixel pipeline reads has changed.
+	if (batch.triangles.size() >= MAX_BATCH_TRIANGLES)
+		KickRasterBatch();
+}
+
+static void RasterizeTiles(RasterContext& tile_context, const RasterBatch& batch)
+{
+	int tile;
+	while ((tile = s_next_tile++) < NUM_TILES)
+	{
+		const std::vector<u32>& bin = batch.bins[tile];
+		if (!bin.empty())
+		{
+			s32 left = (tile % TILES_X) * TILE_SIZE;
+			s32 top = (tile / TILES_X) * TILE_SIZE;
+			s32 right = std::min<s32>(left + TILE_SIZE, EFB_WIDTH);
+			s32 bottom = std::min<s32>(top + TILE_SIZE, EFB_HEIGHT);
+
+			// Every tile starts from the register state the batch was submitted with, so
+			// the result doesn't depend on which thread drew which tile.
+			tile_context.tev.CopyRegColors(context.tev);
+
+			// Triangles are drawn in submission order, which keeps the blending and depth
+			// test order of every pixel the same as on a single thread.
+			for (u32 index : bin)
+			{
+				const TriangleSetup& tri = batch.triangles[index];
+				RasterizeTriangle(tile_context, tri,
+					std::max(tri.minx, left), std::min(tri.maxx, right),
+					std::max(tri.miny, top), std::min(tri.maxy, bottom));
+			}
+		}
+
+		if (--s_remaining_tiles == 0)
+		{
+			std::lock_guard<std::mutex> lk(s_raster_mutex);
+			s_raster_done_cv.notify_all();
+		}
+	}
+}
+
+// Waits until the batch which is being drawn is done and recycles it.
+static void WaitForRasterBatch()
+{
+	if (!s_raster_batch)
+		return;
+
+	// Threads which have claimed their last tile still touch the batch, so wait for them as well.
+	// Threads which wake up late find no batch and go back to sleep.
+	RasterBatch* batch = s_raster_batch;
+	{
+		std::unique_lock<std::mutex> lk(s_raster_mutex);
+		s_raster_done_cv.wait(lk, [] { return s_remaining_tiles == 0 && s_raster_busy_threads == 0; });
+		s_raster_batch = nullptr;
 	}
+
+	for (auto& tile_context : s_tile_contexts)
+		tile_context->counters.Merge();
+
+	batch->triangles.clear();
+	for (std::vector<u32>& bin : batch->bins)
+		bin.clear();
+}
+
+// Hands the current batch to the rasterizer threads without waiting for it to be drawn.
+static void KickRasterBatch()
+{
+	// Batches are drawn one after another, so they stay in submission order.
+	WaitForRasterBatch();
+
+	{
+		std::lock_guard<std::mutex> lk(s_raster_mutex);
+		s_raster_batch = s_current_batch;
+		s_next_tile = 0;
+		s_remaining_tiles = NUM_TILES;
+		s_raster_generation++;
+	}
+	s_raster_cv.notify_all();
+
+	s_current_batch = (s_current_batch == &s_batches[0]) ? &s_batches[1] : &s_batches[0];
+}
+
+void Flush()
+{
+	if (!s_current_batch->triangles.empty())
+		KickRasterBatch();
+
+	if (s_raster_batch)
+	{
+		RasterizeTiles(*s_tile_contexts[0], *s_raster_batch);
+		WaitForRasterBatch();
+	}
+
+	// Whatever requires the pending triangles to be drawn may also change texture data.
+	TextureSampler::InvalidateTexelCaches();
 }
 
 void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVertexData *v2)
@@ -361,15 +966,6 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	const s32 DY23 = Y2 - Y3;
 	const s32 DY31 = Y3 - Y1;
 
-	// Fixed-pos32 deltas
-	const s32 FDX12 = DX12 << 4;
-	const s32 FDX23 = DX23 << 4;
-	const s32 FDX31 = DX31 << 4;
-
-	const s32 FDY12 = DY12 << 4;
-	const s32 FDY23 = DY23 << 4;
-	const s32 FDY31 = DY31 << 4;
-
 	// Bounding rectangle
 	s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
 	s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
@@ -393,28 +989,28 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	float fltdy12 = flty1 - v1->screenPosition.y;
 	float fltdy31 = v2->screenPosition.y - flty1;
 
-	InitTriangle(fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
+	InitTriangle(setup, fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
 
 	float w[3] = { 1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w, 1.0f / v2->projectedPosition.w };
-	InitSlope(&WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+	InitSlope(&setup.WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
 	// TODO: The zfreeze emulation is not quite correct, yet!
 	// Many things might prevent us from reaching this line (culling, clipping, scissoring).
 	// However, the zslope is always guaranteed to be calculated unless all vertices are trivially rejected during clipping!
 	// We're currently sloppy at this since we abort early if any of the culling/clipping/scissoring tests fail.
 	if (!bpmem.genMode.zfreeze || !g_SWVideoConfig.bZFreeze)
-		InitSlope(&ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31, fltdx12, fltdy12, fltdy31);
+		InitSlope(&setup.ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
 	for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
 	{
 		for (int comp = 0; comp < 4; comp++)
-			InitSlope(&ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
+			InitSlope(&setup.ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
 	}
 
 	for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
 	{
 		for (int comp = 0; comp < 3; comp++)
-			InitSlope(&TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+			InitSlope(&setup.TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 	}
 
 	// Half-edge constants
@@ -427,280 +1023,32 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
 	if (DY23 < 0 || (DY23 == 0 && DX23 > 0)) C2++;
 	if (DY31 < 0 || (DY31 == 0 && DX31 > 0)) C3++;
 
-	// If drawing, rasterize every block
-	if (!BoundingBox::active)
+	setup.DX12 = DX12;
+	setup.DX23 = DX23;
+	setup.DX31 = DX31;
+	setup.DY12 = DY12;
+	setup.DY23 = DY23;
+	setup.DY31 = DY31;
+	setup.C1 = C1;
+	setup.C2 = C2;
+	setup.C3 = C3;
+	setup.minx = minx;
+	setup.maxx = maxx;
+	setup.miny = miny;
+	setup.maxy = maxy;
+
+	if (BoundingBox::active)
 	{
-		// Start in corner of 8x8 block
-		minx &= ~(BLOCK_SIZE - 1);
-		miny &= ~(BLOCK_SIZE - 1);
-
-		// Loop through blocks
-		for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
-		{
-			for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
-			{
-				// Corners of block
-				s32 x0 = x << 4;
-				s32 x1 = (x + BLOCK_SIZE - 1) << 4;
-				s32 y0 = y << 4;
-				s32 y1 = (y + BLOCK_SIZE - 1) << 4;
-
-				// Evaluate half-space functions
-				bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
-				bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
-				bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
-				bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
-				int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
-
-				bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
-				bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
-				bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
-				bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
-				int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
-
-				bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
-				bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
-				bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
-				bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
-				int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
-
-				// Skip block when outside an edge
-				if (a == 0x0 || b == 0x0 || c == 0x0)
-					continue;
-
-				BuildBlock(x, y);
-
-				// Accept whole block when totally covered
-				if (a == 0xF && b == 0xF && c == 0xF)
-				{
-					for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-					{
-						for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-						{
-							Draw(x + ix, y + iy, ix, iy);
-						}
-					}
-				}
-				else // Partially covered block
-				{
-					s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
-					s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
-					s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
-
-					for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-					{
-						s32 CX1 = CY1;
-						s32 CX2 = CY2;
-						s32 CX3 = CY3;
-
-						for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-						{
-							if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-							{
-								Draw(x + ix, y + iy, ix, iy);
-							}
-
-							CX1 -= FDY12;
-							CX2 -= FDY23;
-							CX3 -= FDY31;
-						}
-
-						CY1 += FDX12;
-						CY2 += FDX23;
-						CY3 += FDX31;
-					}
-				}
-			}
-		}
+		Flush();
+		CalculateBoundingBox(context, setup);
+	}
+	else if (s_raster_threads.empty() || g_SWVideoConfig.bDumpTevStages || g_SWVideoConfig.bDumpTevTextureFetches)
+	{
+		RasterizeTriangle(context, setup, minx, maxx, miny, maxy);
 	}
 	else
 	{
-		// Calculating bbox
-		// First check for alpha channel - don't do anything it if always fails,
-		// Change bbox to primitive size if it always passes
-		AlphaTest::TEST_RESULT alphaRes = bpmem.alpha_test.TestResult();
-
-		if (alphaRes != AlphaTest::UNDETERMINED)
-		{
-			if (alphaRes == AlphaTest::PASS)
-			{
-				BoundingBox::coords[BoundingBox::TOP]    = std::min(BoundingBox::coords[BoundingBox::TOP],    (u16) miny);
-				BoundingBox::coords[BoundingBox::LEFT]   = std::min(BoundingBox::coords[BoundingBox::LEFT],   (u16) minx);
-				BoundingBox::coords[BoundingBox::BOTTOM] = std::max(BoundingBox::coords[BoundingBox::BOTTOM], (u16) maxy);
-				BoundingBox::coords[BoundingBox::RIGHT]  = std::max(BoundingBox::coords[BoundingBox::RIGHT],  (u16) maxx);
-			}
-			return;
-		}
-
-		// If we are calculating bbox with alpha, we only need to find the
-		// topmost, leftmost, bottom most and rightmost pixels to be drawn.
-		// So instead of drawing every single one of the triangle's pixels,
-		// four loops are run: one for the top pixel, one for the left, one for
-		// the bottom and one for the right. As soon as a pixel that is to be
-		// drawn is found, the loop breaks. This enables a ~150% speedbost in
-		// bbox calculation, albeit at the cost of some ugly repetitive code.
-		const s32 FLEFT   = minx << 4;
-		const s32 FRIGHT  = maxx << 4;
-		s32 FTOP    = miny << 4;
-		s32 FBOTTOM = maxy << 4;
-
-		// Start checking for bbox top
-		s32 CY1 = C1 + DX12 * FTOP - DY12 * FLEFT;
-		s32 CY2 = C2 + DX23 * FTOP - DY23 * FLEFT;
-		s32 CY3 = C3 + DX31 * FTOP - DY31 * FLEFT;
-
-		// Loop
-		for (s32 y = miny; y <= maxy; ++y)
-		{
-			if (y >= BoundingBox::coords[BoundingBox::TOP])
-				break;
-
-			s32 CX1 = CY1;
-			s32 CX2 = CY2;
-			s32 CX3 = CY3;
-
-			for (s32 x = minx; x <= maxx; ++x)
-			{
-				if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-				{
-					// Build the new raster block every other pixel
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
-
-					if (y >= BoundingBox::coords[BoundingBox::TOP])
-						break;
-				}
-
-				CX1 -= FDY12;
-				CX2 -= FDY23;
-				CX3 -= FDY31;
-			}
-
-			CY1 += FDX12;
-			CY2 += FDX23;
-			CY3 += FDX31;
-		}
-
-		// Update top limit
-		miny = std::max((s32) BoundingBox::coords[BoundingBox::TOP], miny);
-		FTOP = miny << 4;
-
-		// Checking for bbox left
-		s32 CX1 = C1 + DX12 * FTOP - DY12 * FLEFT;
-		s32 CX2 = C2 + DX23 * FTOP - DY23 * FLEFT;
-		s32 CX3 = C3 + DX31 * FTOP - DY31 * FLEFT;
-
-		// Loop
-		for (s32 x = minx; x <= maxx; ++x)
-		{
-			if (x >= BoundingBox::coords[BoundingBox::LEFT])
-				break;
-
-			CY1 = CX1;
-			CY2 = CX2;
-			CY3 = CX3;
-
-			for (s32 y = miny; y <= maxy; ++y)
-			{
-				if (CY1 > 0 && CY2 > 0 && CY3 > 0)
-				{
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
-
-					if (x >= BoundingBox::coords[BoundingBox::LEFT])
-						break;
-				}
-
-				CY1 += FDX12;
-				CY2 += FDX23;
-				CY3 += FDX31;
-			}
-
-			CX1 -= FDY12;
-			CX2 -= FDY23;
-			CX3 -= FDY31;
-		}
-
-		// Update left limit
-		minx = std::max((s32) BoundingBox::coords[BoundingBox::LEFT], minx);
-
-		// Checking for bbox bottom
-		CY1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
-		CY2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
-		CY3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
-
-		// Loop
-		for (s32 y = maxy; y >= miny; --y)
-		{
-			CX1 = CY1;
-			CX2 = CY2;
-			CX3 = CY3;
-
-			if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
-				break;
-
-			for (s32 x = maxx; x >= minx; --x)
-			{
-				if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-				{
-					// Build the new raster block every other pixel
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
-
-					if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
-						break;
-				}
-
-				CX1 += FDY12;
-				CX2 += FDY23;
-				CX3 += FDY31;
-			}
-
-			CY1 -= FDX12;
-			CY2 -= FDX23;
-			CY3 -= FDX31;
-		}
-
-		// Update bottom limit
-		maxy = std::min((s32) BoundingBox::coords[BoundingBox::BOTTOM], maxy);
-		FBOTTOM = maxy << 4;
-
-		// Checking for bbox right
-		CX1 = C1 + DX12 * FBOTTOM - DY12 * FRIGHT;
-		CX2 = C2 + DX23 * FBOTTOM - DY23 * FRIGHT;
-		CX3 = C3 + DX31 * FBOTTOM - DY31 * FRIGHT;
-
-		// Loop
-		for (s32 x = maxx; x >= minx; --x)
-		{
-			if (x <= BoundingBox::coords[BoundingBox::RIGHT])
-				break;
-
-			CY1 = CX1;
-			CY2 = CX2;
-			CY3 = CX3;
-
-			for (s32 y = maxy; y >= miny; --y)
-			{
-				if (CY1 > 0 && CY2 > 0 && CY3 > 0)
-				{
-					// Build the new raster block every other pixel
-					PrepareBlock(x, y);
-					Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
-
-					if (x <= BoundingBox::coords[BoundingBox::RIGHT])
-						break;
-				}
-
-				CY1 -= FDX12;
-				CY2 -= FDX23;
-				CY3 -= FDX31;
-			}
-
-			CX1 += FDY12;
-			CX2 += FDY23;
-			CX3 += FDY31;
-		}
+		BinTriangle(setup);
 	}
 }
 
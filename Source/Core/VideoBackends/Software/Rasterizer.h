@@ -11,9 +11,14 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 	void Init();
+	void Shutdown();
 
 	void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVertexData *v2);
 
+	// Draws all triangles which are still waiting for the rasterizer threads.
+	// Must be called before anything they depend on changes.
+	void Flush();
+
 	void SetScissor();
 
 	void SetTevReg(int reg, int comp, bool konst, s16 color);
@@ -24,7 +29,7 @@ namespace Rasterizer
 		float dfdy;
 		float f0;
 
-		float GetValue(float dx, float dy) { return f0 + (dfdx * dx) + (dfdy * dy); }
+		float GetValue(float dx, float dy) const { return f0 + (dfdx * dx) + (dfdy * dy); }
 		void DoState(PointerWrap &p)
 		{
 			p.Do(dfdx);
@@ -17,6 +17,7 @@
 #include "Core/HW/ProcessorInterface.h"
 
 #include "VideoBackends/Software/OpcodeDecoder.h"
+#include "VideoBackends/Software/Rasterizer.h"
 #include "VideoBackends/Software/SWCommandProcessor.h"
 #include "VideoBackends/Software/VideoBackend.h"
 
@@ -327,6 +328,9 @@ bool RunBuffer()
 		availableBytes = writePos - readPos;
 	}
 
+	// The CPU may touch textures or read the EFB once the FIFO has run dry.
+	Rasterizer::Flush();
+
 	cpreg.status.CommandIdle = 1;
 
 	bool ranDecoder = false;
@@ -164,42 +164,59 @@ void SWVertexLoader::ParseVertex(const PortableVertexDeclaration& vdec)
 	ReadVertexAttribute<u8>(&m_Vertex.posMtx, src, vdec.posmtx, 0, 1, false);
 }
 
-void SWVertexLoader::LoadVertex()
+void SWVertexLoader::LoadVertices(u32 count)
 {
 	const PortableVertexDeclaration& vdec = m_CurrentLoader->m_native_vtx_decl;
 
 	// reserve memory for the destination of the vertex loader
 	m_LoadedVertices.resize(vdec.stride + 4);
 
-	// convert the vertex from the gc format to the videocommon (hardware optimized) format
-	u8* old = g_video_buffer_read_ptr;
-	int converted_vertices = m_CurrentLoader->RunVertices(
-		DataReader(g_video_buffer_read_ptr, nullptr), // src
-		DataReader(m_LoadedVertices.data(), m_LoadedVertices.data() + m_LoadedVertices.size()), // dst
-		1, m_primitiveType
-	);
-	g_video_buffer_read_ptr = old + m_CurrentLoader->m_VertexSize;
-
-	if (converted_vertices == 0)
-		return;
-
-	// parse the videocommon format to our own struct format (m_Vertex)
-	ParseVertex(vdec);
-
-	// transform this vertex so that it can be used for rasterization (outVertex)
-	OutputVertexData* outVertex = m_SetupUnit->GetVertex();
-	TransformUnit::TransformPosition(&m_Vertex, outVertex);
-	if (g_main_cp_state.vtx_desc.Normal != NOT_PRESENT)
+	while (count > 0)
 	{
-		TransformUnit::TransformNormal(&m_Vertex, m_CurrentVat->g0.NormalElements, outVertex);
-	}
-	TransformUnit::TransformColor(&m_Vertex, outVertex);
-	TransformUnit::TransformTexCoord(&m_Vertex, outVertex, m_TexGenSpecialCase);
+		int batchSize = 0;
+		for (; count > 0 && batchSize < VERTEX_BATCH_SIZE; count--)
+		{
+			// convert the vertex from the gc format to the videocommon (hardware optimized) format
+			u8* old = g_video_buffer_read_ptr;
+			int converted_vertices = m_CurrentLoader->RunVertices(
+				DataReader(g_video_buffer_read_ptr, nullptr), // src
+				DataReader(m_LoadedVertices.data(), m_LoadedVertices.data() + m_LoadedVertices.size()), // dst
+				1, m_primitiveType
+			);
+			g_video_buffer_read_ptr = old + m_CurrentLoader->m_VertexSize;
+
+			if (converted_vertices == 0)
+				continue;
+
+			// parse the videocommon format to our own struct format (m_Vertex)
+			// attributes which aren't part of the vertex keep the value of the previous one
+			ParseVertex(vdec);
+			m_InputBatch[batchSize++] = m_Vertex;
+		}
 
-	// assemble and rasterize the primitive
-	m_SetupUnit->SetupVertex();
+		// transform the batch so that it can be used for rasterization
+		TransformUnit::TransformPositions(m_InputBatch, m_OutputBatch, batchSize);
+		for (int i = 0; i < batchSize; i++)
+		{
+			const InputVertexData* inVertex = &m_InputBatch[i];
+			OutputVertexData* outVertex = &m_OutputBatch[i];
+			if (g_main_cp_state.vtx_desc.Normal != NOT_PRESENT)
+			{
+				TransformUnit::TransformNormal(inVertex, m_CurrentVat->g0.NormalElements, outVertex);
+			}
+			TransformUnit::TransformColor(inVertex, outVertex);
+			TransformUnit::TransformTexCoord(inVertex, outVertex, m_TexGenSpecialCase);
+		}
+
+		// assemble and rasterize the primitives in submission order
+		for (int i = 0; i < batchSize; i++)
+		{
+			*m_SetupUnit->GetVertex() = m_OutputBatch[i];
+			m_SetupUnit->SetupVertex();
 
-	INCSTAT(swstats.thisFrame.numVerticesLoaded)
+			INCSTAT(swstats.thisFrame.numVerticesLoaded)
+		}
+	}
 }
 
 void SWVertexLoader::DoState(PointerWrap &p)
@@ -19,12 +19,18 @@ class SetupUnit;
 
 class SWVertexLoader
 {
+	// Vertices are transformed in batches of this size before they are handed to the setup unit.
+	enum { VERTEX_BATCH_SIZE = 64 };
+
 	u32 m_VertexSize;
 
 	VAT* m_CurrentVat;
 
 	InputVertexData m_Vertex;
 
+	InputVertexData m_InputBatch[VERTEX_BATCH_SIZE];
+	OutputVertexData m_OutputBatch[VERTEX_BATCH_SIZE];
+
 	void ParseVertex(const PortableVertexDeclaration& vdec);
 
 	SetupUnit *m_SetupUnit;
@@ -46,6 +52,6 @@ public:
 
 	u32 GetVertexSize() { return m_VertexSize; }
 
-	void LoadVertex();
+	void LoadVertices(u32 count);
 	void DoState(PointerWrap &p);
 };
@@ -16,6 +16,7 @@ SWVideoConfig::SWVideoConfig()
 
 	bHwRasterizer = false;
 	bBypassXFB = false;
+	bThreadedRasterizer = false;
 
 	bShowStats = false;
 
@@ -44,6 +45,7 @@ void SWVideoConfig::Load(const char* ini_file)
 	IniFile::Section* rendering = iniFile.GetOrCreateSection("Rendering");
 	rendering->Get("HwRasterizer", &bHwRasterizer, false);
 	rendering->Get("BypassXFB", &bBypassXFB, false);
+	rendering->Get("ThreadedRasterizer", &bThreadedRasterizer, false);
 	rendering->Get("ZComploc", &bZComploc, true);
 	rendering->Get("ZFreeze", &bZFreeze, true);
 
@@ -73,6 +75,7 @@ void SWVideoConfig::Save(const char* ini_file)
 	IniFile::Section* rendering = iniFile.GetOrCreateSection("Rendering");
 	rendering->Set("HwRasterizer", bHwRasterizer);
 	rendering->Set("BypassXFB", bBypassXFB);
+	rendering->Set("ThreadedRasterizer", bThreadedRasterizer);
 	rendering->Set("ZComploc", bZComploc);
 	rendering->Set("ZFreeze", bZFreeze);
 
@@ -106,6 +106,8 @@ void VideoSoftware::DoState(PointerWrap& p)
 		// change mode to abort load of incompatible save state.
 		p.SetMode(PointerWrap::MODE_VERIFY);
 
+	Rasterizer::Flush();
+
 	// TODO: incomplete?
 	SWCommandProcessor::DoState(p);
 	PixelEngine::DoState(p);
@@ -155,6 +157,7 @@ void VideoSoftware::EmuStateChange(EMUSTATE_CHANGE newState)
 void VideoSoftware::Shutdown()
 {
 	// TODO: should be in Video_Cleanup
+	Rasterizer::Shutdown();
 	HwRasterizer::Shutdown();
 	SWRenderer::Shutdown();
 	DebugUtil::Shutdown();
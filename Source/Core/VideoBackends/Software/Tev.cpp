@@ -3,6 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <cmath>
+#include <cstring>
+
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -21,6 +26,10 @@
 #define ALLOW_TEV_DUMPS 0
 #endif
 
+static const s16 s_BiasLUT[4] = { 0, 128, -128, 0 };
+static const u8 s_ScaleLShiftLUT[4] = { 0, 1, 2, 0 };
+static const u8 s_ScaleRShiftLUT[4] = { 0, 0, 0, 1 };
+
 void Tev::Init()
 {
 	FixedConstants[0] = 0;
@@ -108,20 +117,10 @@ void Tev::Init()
 		m_KonstLUT[31][comp] = &KonstantColors[3][ALP_C];
 	}
 
-	m_BiasLUT[0] = 0;
-	m_BiasLUT[1] = 128;
-	m_BiasLUT[2] = -128;
-	m_BiasLUT[3] = 0;
-
-	m_ScaleLShiftLUT[0] = 0;
-	m_ScaleLShiftLUT[1] = 1;
-	m_ScaleLShiftLUT[2] = 2;
-	m_ScaleLShiftLUT[3] = 0;
-
-	m_ScaleRShiftLUT[0] = 0;
-	m_ScaleRShiftLUT[1] = 0;
-	m_ScaleRShiftLUT[2] = 0;
-	m_ScaleRShiftLUT[3] = 1;
+	// The combiners are static and use the tables above, these copies only live on in savestates.
+	memcpy(m_BiasLUT, s_BiasLUT, sizeof(m_BiasLUT));
+	memcpy(m_ScaleLShiftLUT, s_ScaleLShiftLUT, sizeof(m_ScaleLShiftLUT));
+	memcpy(m_ScaleRShiftLUT, s_ScaleRShiftLUT, sizeof(m_ScaleRShiftLUT));
 }
 
 static inline s16 Clamp255(s16 in)
@@ -186,7 +185,7 @@ void Tev::SetRasColor(int colorChan, int swaptable)
 	}
 }
 
-void Tev::DrawColorRegular(TevStageCombiner::ColorCombiner &cc, const InputRegType inputs[4])
+void Tev::DrawColorRegular(const TevStageCombiner::ColorCombiner &cc, const InputRegType inputs[4], s16 result[4])
 {
 	for (int i = 0; i < 3; i++)
 	{
@@ -195,15 +194,15 @@ void Tev::DrawColorRegular(TevStageCombiner::ColorCombiner &cc, const InputRegTy
 		u16 c = InputReg.c + (InputReg.c >> 7);
 
 		s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-		temp <<= m_ScaleLShiftLUT[cc.shift];
+		temp <<= s_ScaleLShiftLUT[cc.shift];
 		temp += (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
 		temp >>= 8;
 		temp = cc.op ? -temp : temp;
 
-		s32 result = ((InputReg.d + m_BiasLUT[cc.bias]) << m_ScaleLShiftLUT[cc.shift]) + temp;
-		result = result >> m_ScaleRShiftLUT[cc.shift];
+		s32 res = ((InputReg.d + s_BiasLUT[cc.bias]) << s_ScaleLShiftLUT[cc.shift]) + temp;
+		res = res >> s_ScaleRShiftLUT[cc.shift];
 
-		Reg[cc.dest][BLU_C + i] = result;
+		result[BLU_C + i] = res;
 	}
 }
 
@@ -264,22 +263,76 @@ void Tev::DrawColorCompare(TevStageCombiner::ColorCombiner &cc, const InputRegTy
 	}
 }
 
-void Tev::DrawAlphaRegular(TevStageCombiner::AlphaCombiner &ac, const InputRegType inputs[4])
+void Tev::DrawAlphaRegular(const TevStageCombiner::AlphaCombiner &ac, const InputRegType inputs[4], s16 result[4])
 {
 	const InputRegType& InputReg = inputs[ALP_C];
 
 	u16 c = InputReg.c + (InputReg.c >> 7);
 
 	s32 temp = InputReg.a * (256 - c) + (InputReg.b * c);
-	temp <<= m_ScaleLShiftLUT[ac.shift];
+	temp <<= s_ScaleLShiftLUT[ac.shift];
 	temp += (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
 	temp = ac.op ? (-temp >> 8) : (temp >> 8);
 
-	s32 result = ((InputReg.d + m_BiasLUT[ac.bias]) << m_ScaleLShiftLUT[ac.shift]) + temp;
-	result = result >> m_ScaleRShiftLUT[ac.shift];
+	s32 res = ((InputReg.d + s_BiasLUT[ac.bias]) << s_ScaleLShiftLUT[ac.shift]) + temp;
+	res = res >> s_ScaleRShiftLUT[ac.shift];
+
+	result[ALP_C] = res;
+}
 
-	Reg[ac.dest][ALP_C] = result;
+#ifdef _M_X86
+void Tev::DrawRegularSSE2(const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac,
+                          const s16 a[4], const s16 b[4], const s16 c[4], const s16 d[4], s16 result[4])
+{
+	// One 16 bit lane per channel, alpha first. Only the lower half of each register is used
+	// until the products are widened to 32 bits.
+	const __m128i mask8 = _mm_set1_epi16(0xFF);
+	__m128i va = _mm_and_si128(_mm_loadl_epi64((const __m128i*)a), mask8);
+	__m128i vb = _mm_and_si128(_mm_loadl_epi64((const __m128i*)b), mask8);
+	__m128i vc = _mm_and_si128(_mm_loadl_epi64((const __m128i*)c), mask8);
+	// d is an 11 bit signed value
+	__m128i vd = _mm_srai_epi16(_mm_slli_epi16(_mm_loadl_epi64((const __m128i*)d), 5), 5);
+
+	int lshiftC = s_ScaleLShiftLUT[cc.shift];
+	int lshiftA = s_ScaleLShiftLUT[ac.shift];
+	const __m128i scale = _mm_setr_epi16(1 << lshiftA, 1 << lshiftC, 1 << lshiftC, 1 << lshiftC, 0, 0, 0, 0);
+
+	// a * (256 - c) + b * c, with the left shift folded into the weights
+	vc = _mm_add_epi16(vc, _mm_srli_epi16(vc, 7));
+	__m128i wa = _mm_mullo_epi16(_mm_sub_epi16(_mm_set1_epi16(256), vc), scale);
+	__m128i wb = _mm_mullo_epi16(vc, scale);
+	__m128i temp = _mm_madd_epi16(_mm_unpacklo_epi16(va, vb), _mm_unpacklo_epi16(wa, wb));
+
+	// The color combiners negate after shifting, the alpha combiner before.
+	int roundC = (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+	int roundA = (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+	const __m128i negate_before = _mm_setr_epi32(ac.op ? -1 : 0, 0, 0, 0);
+	const __m128i negate_after = _mm_setr_epi32(0, cc.op ? -1 : 0, cc.op ? -1 : 0, cc.op ? -1 : 0);
+	temp = _mm_add_epi32(temp, _mm_setr_epi32(roundA, roundC, roundC, roundC));
+	temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_before), negate_before);
+	temp = _mm_srai_epi32(temp, 8);
+	temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_after), negate_after);
+
+	// (d + bias) << shift
+	__m128i bias = _mm_setr_epi16(s_BiasLUT[ac.bias], s_BiasLUT[cc.bias], s_BiasLUT[cc.bias], s_BiasLUT[cc.bias], 0, 0, 0, 0);
+	__m128i vres = _mm_madd_epi16(_mm_unpacklo_epi16(_mm_add_epi16(vd, bias), _mm_setzero_si128()),
+	                              _mm_unpacklo_epi16(scale, _mm_setzero_si128()));
+	vres = _mm_add_epi32(vres, temp);
+
+	const __m128i rshift = _mm_setr_epi32(s_ScaleRShiftLUT[ac.shift] ? -1 : 0, s_ScaleRShiftLUT[cc.shift] ? -1 : 0,
+	                                      s_ScaleRShiftLUT[cc.shift] ? -1 : 0, s_ScaleRShiftLUT[cc.shift] ? -1 : 0);
+	vres = _mm_or_si128(_mm_and_si128(rshift, _mm_srai_epi32(vres, 1)), _mm_andnot_si128(rshift, vres));
+
+	// The results are well inside the s16 range, so saturation never kicks in here.
+	__m128i out = _mm_packs_epi32(vres, vres);
+
+	const __m128i lo = _mm_setr_epi16(ac.clamp ? 0 : -1024, cc.clamp ? 0 : -1024, cc.clamp ? 0 : -1024, cc.clamp ? 0 : -1024, 0, 0, 0, 0);
+	const __m128i hi = _mm_setr_epi16(ac.clamp ? 255 : 1023, cc.clamp ? 255 : 1023, cc.clamp ? 255 : 1023, cc.clamp ? 255 : 1023, 0, 0, 0, 0);
+	out = _mm_max_epi16(_mm_min_epi16(out, hi), lo);
+
+	_mm_storel_epi64((__m128i*)result, out);
 }
+#endif
 
 void Tev::DrawAlphaCompare(TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4])
 {
@@ -509,7 +562,10 @@ void Tev::Draw()
 	_assert_(Position[0] >= 0 && Position[0] < EFB_WIDTH);
 	_assert_(Position[1] >= 0 && Position[1] < EFB_HEIGHT);
 
-	INCSTAT(swstats.thisFrame.tevPixelsIn);
+	if (m_counters)
+		m_counters->tev_pixels_in++;
+	else
+		INCSTAT(swstats.thisFrame.tevPixelsIn);
 
 	for (unsigned int stageNum = 0; stageNum < bpmem.genMode.numindstages; stageNum++)
 	{
@@ -524,7 +580,7 @@ void Tev::Draw()
 		s32 scaleT = stageOdd ? texscale.ts1:texscale.ts0;
 
 		TextureSampler::Sample(Uv[texcoordSel].s >> scaleS, Uv[texcoordSel].t >> scaleT,
-			IndirectLod[stageNum], IndirectLinear[stageNum], texmap, IndirectTex[stageNum]);
+			IndirectLod[stageNum], IndirectLinear[stageNum], texmap, IndirectTex[stageNum], &m_TexelCache);
 
 #if ALLOW_TEV_DUMPS
 		if (g_SWVideoConfig.bDumpTevStages)
@@ -562,7 +618,7 @@ void Tev::Draw()
 			// RGBA
 			u8 texel[4];
 
-			TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum], texmap, texel);
+			TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum], texmap, texel, &m_TexelCache);
 
 #if ALLOW_TEV_DUMPS
 			if (g_SWVideoConfig.bDumpTevTextureFetches)
@@ -590,46 +646,88 @@ void Tev::Draw()
 		SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
 
 		// combine inputs
-		InputRegType inputs[4];
-		for (int i = 0; i < 3; i++)
-		{
-			inputs[BLU_C + i].a = *m_ColorInputLUT[cc.a][i];
-			inputs[BLU_C + i].b = *m_ColorInputLUT[cc.b][i];
-			inputs[BLU_C + i].c = *m_ColorInputLUT[cc.c][i];
-			inputs[BLU_C + i].d = *m_ColorInputLUT[cc.d][i];
-		}
-		inputs[ALP_C].a = *m_AlphaInputLUT[ac.a];
-		inputs[ALP_C].b = *m_AlphaInputLUT[ac.b];
-		inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
-		inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
-
-		if (cc.bias != 3)
-			DrawColorRegular(cc, inputs);
-		else
-			DrawColorCompare(cc, inputs);
-
-		if (cc.clamp)
+#ifdef _M_X86
+		if (cc.bias != 3 && ac.bias != 3)
 		{
-			Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
-			Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
-			Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
+			s16 a[4], b[4], c[4], d[4];
+			for (int i = 0; i < 3; i++)
+			{
+				a[BLU_C + i] = *m_ColorInputLUT[cc.a][i];
+				b[BLU_C + i] = *m_ColorInputLUT[cc.b][i];
+				c[BLU_C + i] = *m_ColorInputLUT[cc.c][i];
+				d[BLU_C + i] = *m_ColorInputLUT[cc.d][i];
+			}
+			a[ALP_C] = *m_AlphaInputLUT[ac.a];
+			b[ALP_C] = *m_AlphaInputLUT[ac.b];
+			c[ALP_C] = *m_AlphaInputLUT[ac.c];
+			d[ALP_C] = *m_AlphaInputLUT[ac.d];
+
+			s16 result[4];
+			DrawRegularSSE2(cc, ac, a, b, c, d, result);
+
+			Reg[cc.dest][RED_C] = result[RED_C];
+			Reg[cc.dest][GRN_C] = result[GRN_C];
+			Reg[cc.dest][BLU_C] = result[BLU_C];
+			Reg[ac.dest][ALP_C] = result[ALP_C];
 		}
 		else
+#endif
 		{
-			Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
-			Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
-			Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
-		}
+			InputRegType inputs[4];
+			for (int i = 0; i < 3; i++)
+			{
+				inputs[BLU_C + i].a = *m_ColorInputLUT[cc.a][i];
+				inputs[BLU_C + i].b = *m_ColorInputLUT[cc.b][i];
+				inputs[BLU_C + i].c = *m_ColorInputLUT[cc.c][i];
+				inputs[BLU_C + i].d = *m_ColorInputLUT[cc.d][i];
+			}
+			inputs[ALP_C].a = *m_AlphaInputLUT[ac.a];
+			inputs[ALP_C].b = *m_AlphaInputLUT[ac.b];
+			inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
+			inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
 
-		if (ac.bias != 3)
-			DrawAlphaRegular(ac, inputs);
-		else
-			DrawAlphaCompare(ac, inputs);
+			if (cc.bias != 3)
+			{
+				s16 result[4];
+				DrawColorRegular(cc, inputs, result);
+				Reg[cc.dest][RED_C] = result[RED_C];
+				Reg[cc.dest][GRN_C] = result[GRN_C];
+				Reg[cc.dest][BLU_C] = result[BLU_C];
+			}
+			else
+			{
+				DrawColorCompare(cc, inputs);
+			}
 
-		if (ac.clamp)
-			Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
-		else
-			Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+			if (cc.clamp)
+			{
+				Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
+				Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
+				Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
+			}
+			else
+			{
+				Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
+				Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
+				Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
+			}
+
+			if (ac.bias != 3)
+			{
+				s16 result[4];
+				DrawAlphaRegular(ac, inputs, result);
+				Reg[ac.dest][ALP_C] = result[ALP_C];
+			}
+			else
+			{
+				DrawAlphaCompare(ac, inputs);
+			}
+
+			if (ac.clamp)
+				Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
+			else
+				Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+		}
 
 #if ALLOW_TEV_DUMPS
 		if (g_SWVideoConfig.bDumpTevStages)
@@ -762,20 +860,21 @@ void Tev::Draw()
 		if (late_ztest && bpmem.zmode.testenable)
 		{
 			// TODO: Check against hw if these values get incremented even if depth testing is disabled
-			EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+			IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
 
 			if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
 				return;
 
-			EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+			IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
 		}
 	}
 
 	// branchless bounding box update
-	BoundingBox::coords[BoundingBox::LEFT] = std::min((u16)Position[0], BoundingBox::coords[BoundingBox::LEFT]);
-	BoundingBox::coords[BoundingBox::RIGHT] = std::max((u16)Position[0], BoundingBox::coords[BoundingBox::RIGHT]);
-	BoundingBox::coords[BoundingBox::TOP] = std::min((u16)Position[1], BoundingBox::coords[BoundingBox::TOP]);
-	BoundingBox::coords[BoundingBox::BOTTOM] = std::max((u16)Position[1], BoundingBox::coords[BoundingBox::BOTTOM]);
+	u16* bbox = m_counters ? m_counters->bbox : BoundingBox::coords;
+	bbox[BoundingBox::LEFT] = std::min((u16)Position[0], bbox[BoundingBox::LEFT]);
+	bbox[BoundingBox::RIGHT] = std::max((u16)Position[0], bbox[BoundingBox::RIGHT]);
+	bbox[BoundingBox::TOP] = std::min((u16)Position[1], bbox[BoundingBox::TOP]);
+	bbox[BoundingBox::BOTTOM] = std::max((u16)Position[1], bbox[BoundingBox::BOTTOM]);
 
 	// if we are only calculating the bounding box,
 	// there's no need to actually draw anything
@@ -803,8 +902,11 @@ void Tev::Draw()
 	}
 #endif
 
-	INCSTAT(swstats.thisFrame.tevPixelsOut);
-	EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+	if (m_counters)
+		m_counters->tev_pixels_out++;
+	else
+		INCSTAT(swstats.thisFrame.tevPixelsOut);
+	IncPerfCounterQuadCount(PQ_BLEND_INPUT);
 
 	EfbInterface::BlendTev(Position[0], Position[1], output);
 }
@@ -821,6 +923,52 @@ void Tev::SetRegColor(int reg, int comp, bool konst, s16 color)
 	}
 }
 
+void Tev::CopyRegColors(const Tev& other)
+{
+	memcpy(Reg, other.Reg, sizeof(Reg));
+	memcpy(KonstantColors, other.KonstantColors, sizeof(KonstantColors));
+}
+
+void Tev::IncPerfCounterQuadCount(PerfQueryType type)
+{
+	if (m_counters)
+		m_counters->perf[type]++;
+	else
+		EfbInterface::IncPerfCounterQuadCount(type);
+}
+
+void Tev::Counters::Reset()
+{
+	memset(perf, 0, sizeof(perf));
+	bbox[BoundingBox::LEFT] = 0xFFFF;
+	bbox[BoundingBox::RIGHT] = 0;
+	bbox[BoundingBox::TOP] = 0xFFFF;
+	bbox[BoundingBox::BOTTOM] = 0;
+	rasterized_pixels = 0;
+	tev_pixels_in = 0;
+	tev_pixels_out = 0;
+}
+
+void Tev::Counters::Merge()
+{
+	for (int type = 0; type < PQ_NUM_MEMBERS; type++)
+	{
+		if (perf[type])
+			EfbInterface::AddPerfCounterPixels((PerfQueryType)type, perf[type]);
+	}
+
+	BoundingBox::coords[BoundingBox::LEFT] = std::min(bbox[BoundingBox::LEFT], BoundingBox::coords[BoundingBox::LEFT]);
+	BoundingBox::coords[BoundingBox::RIGHT] = std::max(bbox[BoundingBox::RIGHT], BoundingBox::coords[BoundingBox::RIGHT]);
+	BoundingBox::coords[BoundingBox::TOP] = std::min(bbox[BoundingBox::TOP], BoundingBox::coords[BoundingBox::TOP]);
+	BoundingBox::coords[BoundingBox::BOTTOM] = std::max(bbox[BoundingBox::BOTTOM], BoundingBox::coords[BoundingBox::BOTTOM]);
+
+	ADDSTAT(swstats.thisFrame.rasterizedPixels, rasterized_pixels);
+	ADDSTAT(swstats.thisFrame.tevPixelsIn, tev_pixels_in);
+	ADDSTAT(swstats.thisFrame.tevPixelsOut, tev_pixels_out);
+
+	Reset();
+}
+
 void Tev::DoState(PointerWrap &p)
 {
 	p.DoArray(Reg, sizeof(Reg));
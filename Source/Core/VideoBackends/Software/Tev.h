@@ -5,11 +5,14 @@
 #pragma once
 
 #include "VideoBackends/Software/BPMemLoader.h"
+#include "VideoBackends/Software/TextureSampler.h"
+#include "VideoCommon/PerfQueryBase.h"
 
 class PointerWrap;
 
 class Tev
 {
+public:
 	struct InputRegType
 	{
 		unsigned a : 8;
@@ -18,6 +21,7 @@ class Tev
 		signed   d : 11;
 	};
 
+private:
 	struct TextureCoordinateType
 	{
 		signed s : 24;
@@ -44,6 +48,8 @@ class Tev
 	u8 m_ScaleLShiftLUT[4];
 	u8 m_ScaleRShiftLUT[4];
 
+	TextureSampler::TexelCache m_TexelCache;
+
 	// enumeration for color input LUT
 	enum
 	{
@@ -61,14 +67,29 @@ class Tev
 
 	void SetRasColor(int colorChan, int swaptable);
 
-	void DrawColorRegular(TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
 	void DrawColorCompare(TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
-	void DrawAlphaRegular(TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
 	void DrawAlphaCompare(TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
 
 	void Indirect(unsigned int stageNum, s32 s, s32 t);
 
 public:
+	// Side effects of Draw() on global state. A Tev which shades pixels on a rasterizer
+	// worker thread collects them here instead, and the rasterizer merges them into the
+	// global state once the batch is drawn.
+	struct Counters
+	{
+		u32 perf[PQ_NUM_MEMBERS];
+		u16 bbox[4];
+		u32 rasterized_pixels;
+		u32 tev_pixels_in;
+		u32 tev_pixels_out;
+
+		void Reset();
+		void Merge();
+	};
+
+	Counters* m_counters = nullptr;
+
 	s32 Position[3];
 	u8 Color[2][4]; // must be RGBA for correct swap table ordering
 	TextureCoordinateType Uv[8];
@@ -89,7 +110,23 @@ public:
 
 	void Draw();
 
+	// Regular (non-compare) combiners. The results are written to the channels of
+	// result which the combiner computes, in the same ABGR order as the registers.
+	static void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4], s16 result[4]);
+	static void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4], s16 result[4]);
+
+#ifdef _M_X86
+	// Computes and clamps both regular combiners of a stage for all four channels at once.
+	// The operands are the unmasked register values, matching DrawColorRegular and
+	// DrawAlphaRegular followed by clamping bit for bit.
+	static void DrawRegularSSE2(const TevStageCombiner::ColorCombiner& cc, const TevStageCombiner::AlphaCombiner& ac,
+	                            const s16 a[4], const s16 b[4], const s16 c[4], const s16 d[4], s16 result[4]);
+#endif
+
 	void SetRegColor(int reg, int comp, bool konst, s16 color);
+	void CopyRegColors(const Tev& other);
+
+	void IncPerfCounterQuadCount(PerfQueryType type);
 
 	void DoState(PointerWrap &p);
 };
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "Common/Common.h"
 #include "Core/HW/Memmap.h"
@@ -16,6 +17,74 @@
 namespace TextureSampler
 {
 
+// Bumped whenever texture data may have changed, which drops the contents of all texel caches.
+// Only changes while no other thread is sampling.
+static u32 s_texel_cache_generation = 1;
+
+TexelCache::TexelCache()
+{
+	memset(this, 0, sizeof(*this));
+}
+
+void InvalidateTexelCaches()
+{
+	s_texel_cache_generation++;
+}
+
+static TexelCache::TexMapCache* GetTexMapCache(TexelCache* cache, u8 texmap, const TexelCache::TextureKey& key)
+{
+	if (cache->generation != s_texel_cache_generation)
+	{
+		cache->generation = s_texel_cache_generation;
+		for (TexelCache::TexMapCache& texmap_cache : cache->texmaps)
+			texmap_cache.key.format = ~0u;
+	}
+
+	TexelCache::TexMapCache& texmap_cache = cache->texmaps[texmap];
+	if (memcmp(&texmap_cache.key, &key, sizeof(key)))
+	{
+		texmap_cache.key = key;
+
+		// Entries from older epochs never match, so they only need to be cleared once the epoch wraps around.
+		texmap_cache.epoch = (texmap_cache.epoch + 1) & 0xFF;
+		if (texmap_cache.epoch == 0)
+		{
+			memset(texmap_cache.entries, 0, sizeof(texmap_cache.entries));
+			texmap_cache.epoch = 1;
+		}
+	}
+
+	return &texmap_cache;
+}
+
+static inline void DecodeTexel(u8 *texel, const u8 *imageSrc, const u8 *imageSrcOdd, int s, int t, int imageWidth,
+                               int format, const u8 *tlut, TlutFormat tlutfmt, TexelCache::TexMapCache* texmap_cache, u32 mip)
+{
+	TexelCache::Entry* entry = nullptr;
+	u32 tag = 0;
+	if (texmap_cache && (u32)s < 1024 && (u32)t < 1024 && mip < 16)
+	{
+		tag = (texmap_cache->epoch << 24) | (mip << 20) | (t << 10) | s;
+		entry = &texmap_cache->entries[(s & 0xF) | ((t & 0xF) << 4)];
+		if (entry->tag == tag)
+		{
+			memcpy(texel, entry->texel, 4);
+			return;
+		}
+	}
+
+	if (imageSrcOdd)
+		TexDecoder_DecodeTexelRGBA8FromTmem(texel, imageSrc, imageSrcOdd, s, t, imageWidth);
+	else
+		TexDecoder_DecodeTexel(texel, imageSrc, s, t, imageWidth, format, tlut, tlutfmt);
+
+	if (entry)
+	{
+		entry->tag = tag;
+		memcpy(entry->texel, texel, 4);
+	}
+}
+
 static inline void WrapCoord(int* coordp, int wrapMode, int imageSize)
 {
 	int coord = *coordp;
@@ -57,7 +126,7 @@ static inline void AddTexel(u8 *inTexel, u32 *outTexel, u32 fract)
 	outTexel[3] += inTexel[3] * fract;
 }
 
-void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample)
+void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample, TexelCache* cache)
 {
 	int baseMip = 0;
 	bool mipLinear = false;
@@ -83,10 +152,10 @@ void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample)
 		u8 sampledTex[4];
 		u32 texel[4];
 
-		SampleMip(s, t, baseMip, linear, texmap, sampledTex);
+		SampleMip(s, t, baseMip, linear, texmap, sampledTex, cache);
 		SetTexel(sampledTex, texel, (16 - lodFract));
 
-		SampleMip(s, t, baseMip + 1, linear, texmap, sampledTex);
+		SampleMip(s, t, baseMip + 1, linear, texmap, sampledTex, cache);
 		AddTexel(sampledTex, texel, lodFract);
 
 		sample[0] = (u8)(texel[0] >> 4);
@@ -97,11 +166,11 @@ void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample)
 	else
 #endif
 	{
-		SampleMip(s, t, baseMip, linear, texmap, sample);
+		SampleMip(s, t, baseMip, linear, texmap, sample, cache);
 	}
 }
 
-void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample)
+void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample, TexelCache* cache)
 {
 	FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
 	u8 subTexmap = texmap & 3;
@@ -130,6 +199,14 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample)
 	int tlutAddress = texTlut.tmem_offset << 9;
 	const u8* tlut = &texMem[tlutAddress];
 
+	TexelCache::TexMapCache* texmap_cache = nullptr;
+	if (cache)
+	{
+		TexelCache::TextureKey key = { imageSrc, imageSrcOdd, tlut, ti0.format, (u32)tlutfmt, ti0.width, ti0.height };
+		texmap_cache = GetTexMapCache(cache, texmap, key);
+	}
+	u32 mipLevel = mip;
+
 	// reduce sample location and texture size to mip level
 	// move texture pointer to mip location
 	if (mip)
@@ -184,34 +261,17 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample)
 		WrapCoord(&imageSPlus1, tm0.wrap_s, imageWidth);
 		WrapCoord(&imageTPlus1, tm0.wrap_t, imageHeight);
 
-		if (!(ti0.format == GX_TF_RGBA8 && texUnit.texImage1[subTexmap].image_type))
-		{
-			TexDecoder_DecodeTexel(sampledTex, imageSrc, imageS, imageT, imageWidth, ti0.format, tlut, tlutfmt);
-			SetTexel(sampledTex, texel, (128 - fractS) * (128 - fractT));
-
-			TexDecoder_DecodeTexel(sampledTex, imageSrc, imageSPlus1, imageT, imageWidth, ti0.format, tlut, tlutfmt);
-			AddTexel(sampledTex, texel, (fractS) * (128 - fractT));
+		DecodeTexel(sampledTex, imageSrc, imageSrcOdd, imageS, imageT, imageWidth, ti0.format, tlut, tlutfmt, texmap_cache, mipLevel);
+		SetTexel(sampledTex, texel, (128 - fractS) * (128 - fractT));
 
-			TexDecoder_DecodeTexel(sampledTex, imageSrc, imageS, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt);
-			AddTexel(sampledTex, texel, (128 - fractS) * (fractT));
+		DecodeTexel(sampledTex, imageSrc, imageSrcOdd, imageSPlus1, imageT, imageWidth, ti0.format, tlut, tlutfmt, texmap_cache, mipLevel);
+		AddTexel(sampledTex, texel, (fractS) * (128 - fractT));
 
-			TexDecoder_DecodeTexel(sampledTex, imageSrc, imageSPlus1, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt);
-			AddTexel(sampledTex, texel, (fractS) * (fractT));
-		}
-		else
-		{
-			TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageS, imageT, imageWidth);
-			SetTexel(sampledTex, texel, (128 - fractS) * (128 - fractT));
-
-			TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageSPlus1, imageT, imageWidth);
-			AddTexel(sampledTex, texel, (fractS) * (128 - fractT));
+		DecodeTexel(sampledTex, imageSrc, imageSrcOdd, imageS, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt, texmap_cache, mipLevel);
+		AddTexel(sampledTex, texel, (128 - fractS) * (fractT));
 
-			TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageS, imageTPlus1, imageWidth);
-			AddTexel(sampledTex, texel, (128 - fractS) * (fractT));
-
-			TexDecoder_DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageSPlus1, imageTPlus1, imageWidth);
-			AddTexel(sampledTex, texel, (fractS) * (fractT));
-		}
+		DecodeTexel(sampledTex, imageSrc, imageSrcOdd, imageSPlus1, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt, texmap_cache, mipLevel);
+		AddTexel(sampledTex, texel, (fractS) * (fractT));
 
 		sample[0] = (u8)(texel[0] >> 14);
 		sample[1] = (u8)(texel[1] >> 14);
@@ -228,10 +288,7 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample)
 		WrapCoord(&imageS, tm0.wrap_s, imageWidth);
 		WrapCoord(&imageT, tm0.wrap_t, imageHeight);
 
-		if (!(ti0.format == GX_TF_RGBA8 && texUnit.texImage1[subTexmap].image_type))
-			TexDecoder_DecodeTexel(sample, imageSrc, imageS, imageT, imageWidth, ti0.format, tlut, tlutfmt);
-		else
-			TexDecoder_DecodeTexelRGBA8FromTmem(sample, imageSrc, imageSrcOdd, imageS, imageT, imageWidth);
+		DecodeTexel(sample, imageSrc, imageSrcOdd, imageS, imageT, imageWidth, ti0.format, tlut, tlutfmt, texmap_cache, mipLevel);
 	}
 }
 
@@ -8,9 +8,53 @@
 
 namespace TextureSampler
 {
-	void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample);
+	// Recently decoded texels of each texture map. Neighbouring pixels mostly read the
+	// same texels, and decoding them is the expensive part of sampling paletted and
+	// compressed formats. Every thread which samples textures owns its own cache.
+	struct TexelCache
+	{
+		enum
+		{
+			CACHE_SIZE = 256
+		};
+
+		struct TextureKey
+		{
+			const u8* imageSrc;
+			const u8* imageSrcOdd;
+			const u8* tlut;
+			u32 format;
+			u32 tlutFormat;
+			u32 width;
+			u32 height;
+		};
+
+		struct Entry
+		{
+			u32 tag;
+			u8 texel[4];
+		};
+
+		struct TexMapCache
+		{
+			TextureKey key;
+			u32 epoch;
+			Entry entries[CACHE_SIZE];
+		};
+
+		u32 generation;
+		TexMapCache texmaps[8];
+
+		TexelCache();
+	};
+
+	// Drops the contents of all texel caches. Must be called whenever texture memory,
+	// main memory or the TLUTs may have changed, while no thread is sampling textures.
+	void InvalidateTexelCaches();
+
+	void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample, TexelCache* cache = nullptr);
 
-	void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample);
+	void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample, TexelCache* cache = nullptr);
 
 	enum
 	{
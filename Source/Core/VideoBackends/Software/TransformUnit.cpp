@@ -5,6 +5,10 @@
 #include <algorithm>
 #include <cmath>
 
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
+
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
 
@@ -86,6 +90,85 @@ void TransformPosition(const InputVertexData *src, OutputVertexData *dst)
 	}
 }
 
+#ifdef _M_X86
+// Transforms the positions of four vertices which use the same position matrix, one vertex per lane.
+// The operations are done in the same order as in the scalar functions above, so the results are
+// bit-exact.
+static void TransformPositionsSSE2(const InputVertexData *src, OutputVertexData *dst)
+{
+	const float* mat = (const float*)&xfmem.posMatrices[src[0].posMtx * 4];
+
+	const __m128 x = _mm_setr_ps(src[0].position.x, src[1].position.x, src[2].position.x, src[3].position.x);
+	const __m128 y = _mm_setr_ps(src[0].position.y, src[1].position.y, src[2].position.y, src[3].position.y);
+	const __m128 z = _mm_setr_ps(src[0].position.z, src[1].position.z, src[2].position.z, src[3].position.z);
+
+	__m128 mv[3];
+	for (int row = 0; row < 3; row++)
+	{
+		const float* m = &mat[row * 4];
+		__m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), x), _mm_mul_ps(_mm_set1_ps(m[1]), y));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m[2]), z));
+		mv[row] = _mm_add_ps(r, _mm_set1_ps(m[3]));
+	}
+
+	const float* proj = xfmem.projection.rawProjection;
+	__m128 projected[4];
+	if (xfmem.projection.type == GX_PERSPECTIVE)
+	{
+		projected[0] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mv[0]), _mm_mul_ps(_mm_set1_ps(proj[1]), mv[2]));
+		projected[1] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mv[1]), _mm_mul_ps(_mm_set1_ps(proj[3]), mv[2]));
+		projected[2] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mv[2]), _mm_set1_ps(proj[5])),
+		                          _mm_set1_ps(1.0f - (float)1e-7));
+		projected[3] = _mm_xor_ps(mv[2], _mm_set1_ps(-0.0f));
+	}
+	else
+	{
+		projected[0] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mv[0]), _mm_set1_ps(proj[1]));
+		projected[1] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mv[1]), _mm_set1_ps(proj[3]));
+		projected[2] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mv[2]), _mm_set1_ps(proj[5]));
+		projected[3] = _mm_set1_ps(1.0f);
+	}
+
+	float out[7][4];
+	for (int i = 0; i < 3; i++)
+		_mm_storeu_ps(out[i], mv[i]);
+	for (int i = 0; i < 4; i++)
+		_mm_storeu_ps(out[3 + i], projected[i]);
+
+	for (int v = 0; v < 4; v++)
+	{
+		dst[v].mvPosition.x = out[0][v];
+		dst[v].mvPosition.y = out[1][v];
+		dst[v].mvPosition.z = out[2][v];
+		dst[v].projectedPosition.x = out[3][v];
+		dst[v].projectedPosition.y = out[4][v];
+		dst[v].projectedPosition.z = out[5][v];
+		dst[v].projectedPosition.w = out[6][v];
+	}
+}
+#endif
+
+void TransformPositions(const InputVertexData *src, OutputVertexData *dst, int count)
+{
+	int i = 0;
+#ifdef _M_X86
+	for (; i + 4 <= count; i += 4)
+	{
+		if (src[i].posMtx == src[i + 1].posMtx && src[i].posMtx == src[i + 2].posMtx && src[i].posMtx == src[i + 3].posMtx)
+		{
+			TransformPositionsSSE2(&src[i], &dst[i]);
+		}
+		else
+		{
+			for (int j = i; j < i + 4; j++)
+				TransformPosition(&src[j], &dst[j]);
+		}
+	}
+#endif
+	for (; i < count; i++)
+		TransformPosition(&src[i], &dst[i]);
+}
+
 void TransformNormal(const InputVertexData *src, bool nbt, OutputVertexData *dst)
 {
 	const float* mat = (const float*)&xfmem.normalMatrices[(src->posMtx & 31)  * 3];
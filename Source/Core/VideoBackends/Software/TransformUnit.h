@@ -15,6 +15,8 @@ namespace TransformUnit
 	void MultiplyVec3Mat34(const float *vec, const float *mat, float *result);
 
 	void TransformPosition(const InputVertexData *src, OutputVertexData *dst);
+	// Transforms the positions of count vertices, four at a time where the CPU allows it.
+	void TransformPositions(const InputVertexData *src, OutputVertexData *dst, int count);
 	void TransformNormal(const InputVertexData *src, bool nbt, OutputVertexData *dst);
 	void TransformColor(const InputVertexData *src, OutputVertexData *dst);
 	void TransformTexCoord(const InputVertexData *src, OutputVertexData *dst, bool specialCase);
@@ -6,6 +6,7 @@
 #include "Core/HW/Memmap.h"
 #include "VideoBackends/Software/Clipper.h"
 #include "VideoBackends/Software/CPMemLoader.h"
+#include "VideoBackends/Software/Rasterizer.h"
 #include "VideoBackends/Software/XFMemLoader.h"
 #include "VideoCommon/VideoCommon.h"
 
@@ -62,6 +63,10 @@ void SWLoadXFReg(u32 transferSize, u32 baseAddress, u32 *pData)
 	// write to XF regs
 	if (transferSize > 0)
 	{
+		// The pixel pipeline only reads registers, matrices and lights are applied before triangles are queued.
+		if (baseAddress + transferSize > 0x1000)
+			Rasterizer::Flush();
+
 		memcpy((u32*)(&xfmem) + baseAddress, pData, transferSize * 4);
 		XFWritten(transferSize, baseAddress);
 	}
@@ -20,6 +20,7 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoCommon.h"
@@ -41,6 +42,35 @@ void BPInit()
 	bpmem.bpMask = 0xFFFFFF;
 }
 
+// Flags the shader uids which are generated from the given register as dirty.
+static void SetShaderUidsDirty(u32 address)
+{
+	switch (address)
+	{
+	case BPMEM_GENMODE:
+		PixelShaderManager::uid_dirty = true;
+		GeometryShaderManager::uid_dirty = true;
+		return;
+	case BPMEM_IREF:
+	case BPMEM_ZMODE:
+	case BPMEM_ZCOMPARE:
+	case BPMEM_FOGRANGE:
+	case BPMEM_FOGPARAM3:
+	case BPMEM_ALPHACOMPARE:
+	case BPMEM_ZTEX2:
+		PixelShaderManager::uid_dirty = true;
+		return;
+	}
+
+	if ((address >= BPMEM_IND_CMD && address < BPMEM_IND_CMD + 16) ||
+	    (address >= BPMEM_TREF && address < BPMEM_TREF + 8) ||
+	    (address >= BPMEM_TEV_COLOR_ENV && address < BPMEM_TEV_COLOR_ENV + 32) ||
+	    (address >= BPMEM_TEV_KSEL && address < BPMEM_TEV_KSEL + 8))
+	{
+		PixelShaderManager::uid_dirty = true;
+	}
+}
+
 static void BPWritten(const BPCmd& bp)
 {
 	/*
@@ -84,6 +114,7 @@ static void BPWritten(const BPCmd& bp)
 	FlushPipeline();
 
 	((u32*)&bpmem)[bp.address] = bp.newvalue;
+	SetShaderUidsDirty(bp.address);
 
 	switch (bp.address)
 	{
@@ -175,6 +206,8 @@ static void BPWritten(const BPCmd& bp)
 		switch (bp.newvalue & 0xFF)
 		{
 		case 0x02:
+			// The CPU may read back EFB copies once it knows that the GPU is done.
+			g_texture_cache->FlushEFBCopies();
 			if (!g_use_deterministic_gpu_thread)
 				PixelEngine::SetFinish(); // may generate interrupt
 			DEBUG_LOG(VIDEO, "GXSetDrawDone SetPEFinish (value: 0x%02X)", (bp.newvalue & 0xFFFF));
@@ -186,11 +219,13 @@ static void BPWritten(const BPCmd& bp)
 		}
 		return;
 	case BPMEM_PE_TOKEN_ID: // Pixel Engine Token ID
+		g_texture_cache->FlushEFBCopies();
 		if (!g_use_deterministic_gpu_thread)
 			PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), false);
 		DEBUG_LOG(VIDEO, "SetPEToken 0x%04x", (bp.newvalue & 0xFFFF));
 		return;
 	case BPMEM_PE_TOKEN_INT_ID: // Pixel Engine Interrupt Token ID
+		g_texture_cache->FlushEFBCopies();
 		if (!g_use_deterministic_gpu_thread)
 			PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), true);
 		DEBUG_LOG(VIDEO, "SetPEToken + INT 0x%04x", (bp.newvalue & 0xFFFF));
@@ -276,6 +311,7 @@ static void BPWritten(const BPCmd& bp)
 			if (!SConfig::GetInstance().m_LocalCoreStartupParameter.bWii)
 				addr = addr & 0x01FFFFFF;
 
+			g_texture_cache->FlushEFBCopiesInRange(addr, tlutXferCount);
 			Memory::CopyFromEmu(texMem + tlutTMemAddr, addr, tlutXferCount);
 
 			return;
@@ -460,6 +496,9 @@ static void BPWritten(const BPCmd& bp)
 			u32 size = tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE;
 			u32 tmem_addr_even = tmem_cfg.preload_tmem_even * TMEM_LINE_SIZE;
 
+			// RGBA8 preloads read twice as much from RAM
+			g_texture_cache->FlushEFBCopiesInRange(src_addr, size * 2);
+
 			if (tmem_cfg.preload_tile_info.type != 3)
 			{
 				if (tmem_addr_even + size > TMEM_SIZE)
@@ -347,6 +347,7 @@ void GatherPipeBursted()
 		CoreTiming::ForceExceptionCheck(0);
 
 	Common::AtomicAdd(fifo.CPReadWriteDistance, GATHER_PIPE_SIZE);
+	WakeGpuThread();
 
 	RunGpu();
 
@@ -375,6 +376,7 @@ void UpdateInterrupts(u64 userdata)
 	}
 	CoreTiming::ForceExceptionCheck(0);
 	interruptWaiting = false;
+	WakeGpuThread();
 }
 
 void UpdateInterruptsFromVideoBackend(u64 userdata)
@@ -525,6 +527,7 @@ void SetCpControlRegister()
 	else
 	{
 		fifo.bFF_GPReadEnable = m_CPCtrlReg.GPReadEnable;
+		WakeGpuThread();
 	}
 
 	DEBUG_LOG(COMMANDPROCESSOR, "\t GPREAD %s | BP %s | Int %s | OvF %s | UndF %s | LINK %s"
@@ -45,6 +45,7 @@ struct VertexShaderConstants
 	float4 normalmatrices[32];
 	float4 posttransformmatrices[64];
 	float4 pixelcentercorrection;
+	float4 drawmatrices[32 * 6]; // position and normal matrix of each batched draw
 };
 
 struct GeometryShaderConstants
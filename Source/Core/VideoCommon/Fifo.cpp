@@ -2,12 +2,19 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
 #include "Common/Atomic.h"
 #include "Common/ChunkFile.h"
 #include "Common/CPUDetect.h"
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
+#include "Common/Timer.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -21,6 +28,8 @@
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/PixelEngine.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -30,6 +39,17 @@ static volatile bool GpuRunningState = false;
 static volatile bool EmuRunningState = false;
 static std::mutex m_csHWVidOccupied;
 
+// The GPU thread spins for a while and then sleeps when it runs out of work, until
+// WakeGpuThread is called. s_gpu_wakeup_time is the time of the first wakeup since
+// the GPU thread last went idle, or 0 if nothing happened since.
+static const int MAX_GPU_SPIN_COUNT = 1024;
+static const int MAX_GPU_SPIN_COUNT_FEW_CORES = 16;
+static std::mutex s_gpu_wakeup_lock;
+static std::condition_variable s_gpu_wakeup_cond;
+static std::atomic<u64> s_gpu_wakeup_time;
+static std::atomic<bool> s_gpu_sleeping;
+static int s_gpu_spin_count;
+
 // Most of this array is unlikely to be faulted in...
 static u8 s_fifo_aux_data[FIFO_SIZE];
 static u8* s_fifo_aux_write_ptr;
@@ -140,17 +160,78 @@ void ExitGpuLoop()
 	// Terminate GPU thread loop
 	GpuRunningState = false;
 	EmuRunningState = true;
+	WakeGpuThread();
 }
 
 void EmulatorState(bool running)
 {
 	EmuRunningState = running;
+	WakeGpuThread();
+}
+
+void WakeGpuThread()
+{
+	// Only the first wakeup needs to do anything, the GPU thread isn't idle after that.
+	if (s_gpu_wakeup_time.load(std::memory_order_relaxed))
+		return;
+
+	u64 expected = 0;
+	if (!s_gpu_wakeup_time.compare_exchange_strong(expected, Common::Timer::GetTimeUs()))
+		return;
+
+	if (s_gpu_sleeping)
+	{
+		std::lock_guard<std::mutex> lk(s_gpu_wakeup_lock);
+		s_gpu_wakeup_cond.notify_one();
+	}
+}
+
+// Waits until WakeGpuThread is called or the timeout passes. The timeout keeps
+// window messages flowing and covers state changes which don't wake us.
+static void WaitForGpuWork(bool few_cores)
+{
+	int max_spin_count = few_cores ? MAX_GPU_SPIN_COUNT_FEW_CORES : MAX_GPU_SPIN_COUNT;
+
+	// Spin first, work usually arrives quickly while a game is rendering.
+	for (int i = 0; i < s_gpu_spin_count; i++)
+	{
+		if (s_gpu_wakeup_time)
+		{
+			s_gpu_spin_count = std::min(s_gpu_spin_count * 2 + 1, max_spin_count);
+			s_gpu_wakeup_time = 0;
+			return;
+		}
+		Common::YieldCPU();
+	}
+
+	bool woken;
+	{
+		std::unique_lock<std::mutex> lk(s_gpu_wakeup_lock);
+		s_gpu_sleeping = true;
+		woken = s_gpu_wakeup_cond.wait_for(lk, std::chrono::milliseconds(1), [] { return s_gpu_wakeup_time != 0; });
+		s_gpu_sleeping = false;
+	}
+
+	u64 wakeup_time = s_gpu_wakeup_time.exchange(0);
+	if (woken)
+	{
+		u32 latency = (u32)(Common::Timer::GetTimeUs() - wakeup_time);
+		INCSTAT(stats.thisFrame.numGpuThreadWakeups);
+		ADDSTAT(stats.thisFrame.gpuWakeupLatencyTotalUs, latency);
+		if ((int)latency > stats.thisFrame.gpuWakeupLatencyMaxUs)
+			SETSTAT(stats.thisFrame.gpuWakeupLatencyMaxUs, latency);
+	}
+
+	// Spinning didn't pay off this time.
+	s_gpu_spin_count = std::max(s_gpu_spin_count / 2, 1);
 }
 
 void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
 	if (g_use_deterministic_gpu_thread && GpuRunningState)
 	{
+		WakeGpuThread();
+
 		std::unique_lock<std::mutex> lk(s_video_buffer_lock);
 		u8* write_ptr = s_video_buffer_write_ptr;
 		s_video_buffer_cond.wait(lk, [&]() {
@@ -256,6 +337,7 @@ static void ReadDataFromFifoOnCPU(u32 readPtr)
 	s_video_buffer_pp_read_ptr = OpcodeDecoder_Run<true>(DataReader(s_video_buffer_pp_read_ptr, write_ptr + len), nullptr, false);
 	// This would have to be locked if the GPU thread didn't spin.
 	s_video_buffer_write_ptr = write_ptr + len;
+	WakeGpuThread();
 }
 
 void ResetVideoBuffer()
@@ -278,9 +360,10 @@ void RunGpuLoop()
 	SCPFifoStruct &fifo = CommandProcessor::fifo;
 	u32 cyclesExecuted = 0;
 
-	// If the host CPU has only two cores, idle loop instead of busy loop
+	// If the host CPU has only two cores, barely spin before going to sleep.
 	// This allows a system that we are maxing out in dual core mode to do other things
-	bool yield_cpu = cpu_info.num_cores <= 2;
+	bool few_cores = cpu_info.num_cores <= 2;
+	s_gpu_spin_count = 1;
 
 	while (GpuRunningState)
 	{
@@ -360,17 +443,20 @@ void RunGpuLoop()
 			// NOTE(jsd): Calling SwitchToThread() on Windows 7 x64 is a hot spot, according to profiler.
 			// See https://docs.google.com/spreadsheet/ccc?key=0Ah4nh0yGtjrgdFpDeF9pS3V6RUotRVE3S3J4TGM1NlE#gid=0
 			// for benchmark details.
-			if (yield_cpu)
-				Common::YieldCPU();
+			WaitForGpuWork(few_cores);
 		}
 		else
 		{
+			// The CPU thread may save the RAM while paused, so deferred EFB copies have to be in it.
+			if (g_texture_cache)
+				g_texture_cache->FlushEFBCopies();
+
 			// While the emu is paused, we still handle async requests then sleep.
 			while (!EmuRunningState)
 			{
 				g_video_backend->PeekMessages();
 				m_csHWVidOccupied.unlock();
-				Common::SleepCurrentThread(1);
+				WaitForGpuWork(few_cores);
 				m_csHWVidOccupied.lock();
 			}
 		}
@@ -49,6 +49,8 @@ void* PopFifoAuxBuffer(size_t size);
 void RunGpu();
 void RunGpuLoop();
 void ExitGpuLoop();
+// Called when the GPU thread might have new work, e.g. new FIFO data or an async request.
+void WakeGpuThread();
 void EmulatorState(bool running);
 bool AtBreakpoint();
 void ResetVideoBuffer();
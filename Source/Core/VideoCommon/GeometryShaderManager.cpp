@@ -18,6 +18,7 @@ static const int LINE_PT_TEX_OFFSETS[8] = {
 
 GeometryShaderConstants GeometryShaderManager::constants;
 bool GeometryShaderManager::dirty;
+bool GeometryShaderManager::uid_dirty;
 
 static bool s_projection_changed;
 static bool s_viewport_changed;
@@ -31,6 +32,7 @@ void GeometryShaderManager::Init()
 	SetProjectionChanged();
 
 	dirty = true;
+	uid_dirty = true;
 }
 
 void GeometryShaderManager::Shutdown()
@@ -44,6 +46,7 @@ void GeometryShaderManager::Dirty()
 	s_projection_changed = true;
 
 	dirty = true;
+	uid_dirty = true;
 }
 
 void GeometryShaderManager::SetConstants()
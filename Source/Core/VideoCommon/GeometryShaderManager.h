@@ -26,4 +26,8 @@ public:
 
 	static GeometryShaderConstants constants;
 	static bool dirty;
+
+	// Set whenever state feeding the shader uid changes, so the backend only
+	// has to regenerate the uid when this is set.
+	static bool uid_dirty;
 };
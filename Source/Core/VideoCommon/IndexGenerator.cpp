@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <cstddef>
+#include <cstring>
 
 #include "Common/CommonTypes.h"
 #include "VideoCommon/IndexGenerator.h"
@@ -16,6 +17,22 @@ u32 IndexGenerator::base_index;
 
 static const u16 s_primitive_restart = -1;
 
+// Raw GX vertices of the current primitive, index 0 is at s_vertex_base. The decoded
+// ones can't be used for this, they are in a buffer which may only be written to.
+// Within one primitive, the vertex loader and the arrays are the same for all
+// vertices, so identical raw vertices give identical decoded ones.
+static const u8* s_vertex_base;
+static u32 s_vertex_size;
+
+// With primitive restart, triangle lists are written as one strip per triangle.
+// Consecutive triangles of a primitive sharing an edge with identical vertex data
+// are joined into a single strip instead, see JoinListStrip. s_list_strip_end points
+// behind the restart index of the last such strip, the others describe how it would
+// continue.
+static u16* s_list_strip_end;
+static u32 s_list_strip_a, s_list_strip_b;
+static bool s_list_strip_odd;
+
 static u16* (*primitive_table[8])(u16*, u32, u32);
 
 void IndexGenerator::Init()
@@ -46,10 +63,15 @@ void IndexGenerator::Start(u16* Indexptr)
 	index_buffer_current = Indexptr;
 	BASEIptr = Indexptr;
 	base_index = 0;
+	s_list_strip_end = nullptr;
 }
 
-void IndexGenerator::AddIndices(int primitive, u32 numVerts)
+void IndexGenerator::AddIndices(int primitive, u32 numVerts, const u8* src_vertices, u32 vertex_size)
 {
+	s_vertex_base = src_vertices ? src_vertices - base_index * vertex_size : nullptr;
+	s_vertex_size = vertex_size;
+	// Vertices of earlier primitives may have been decoded with other array states.
+	s_list_strip_end = nullptr;
 	index_buffer_current = primitive_table[primitive](index_buffer_current, numVerts, base_index);
 	base_index += numVerts;
 }
@@ -65,11 +87,59 @@ template <bool pr> __forceinline u16* IndexGenerator::WriteTriangle(u16 *Iptr, u
 	return Iptr;
 }
 
+static bool SameVertex(u32 index1, u32 index2)
+{
+	return index1 == index2 ||
+	       !memcmp(s_vertex_base + index1 * s_vertex_size, s_vertex_base + index2 * s_vertex_size, s_vertex_size);
+}
+
+// Appends the triangle to the last triangle list strip if it continues it with the
+// same winding. Odd strip triangles are drawn as (b, a, new), even ones as (a, b, new).
+static bool JoinListStrip(u16 *Iptr, u32 index1, u32 index2, u32 index3)
+{
+	if (Iptr != s_list_strip_end)
+		return false;
+
+	u32 edge1 = s_list_strip_odd ? s_list_strip_b : s_list_strip_a;
+	u32 edge2 = s_list_strip_odd ? s_list_strip_a : s_list_strip_b;
+	u32 triangle[5] = { index1, index2, index3, index1, index2 };
+
+	for (int i = 0; i < 3; ++i)
+	{
+		if (SameVertex(triangle[i], edge1) && SameVertex(triangle[i + 1], edge2))
+		{
+			// Replace the restart index.
+			Iptr[-1] = triangle[i + 2];
+			Iptr[0] = s_primitive_restart;
+			s_list_strip_end = Iptr + 1;
+			s_list_strip_a = s_list_strip_b;
+			s_list_strip_b = triangle[i + 2];
+			s_list_strip_odd = !s_list_strip_odd;
+			return true;
+		}
+	}
+	return false;
+}
+
 template <bool pr> u16* IndexGenerator::AddList(u16 *Iptr, u32 const numVerts, u32 index)
 {
 	for (u32 i = 2; i < numVerts; i+=3)
 	{
+		if (pr && s_vertex_base && JoinListStrip(Iptr, index + i - 2, index + i - 1, index + i))
+		{
+			Iptr = s_list_strip_end;
+			continue;
+		}
+
 		Iptr = WriteTriangle<pr>(Iptr, index + i - 2, index + i - 1, index + i);
+
+		if (pr)
+		{
+			s_list_strip_end = Iptr;
+			s_list_strip_a = index + i - 1;
+			s_list_strip_b = index + i;
+			s_list_strip_odd = true;
+		}
 	}
 	return Iptr;
 }
@@ -16,7 +16,9 @@ public:
 	static void Init();
 	static void Start(u16 *Indexptr);
 
-	static void AddIndices(int primitive, u32 numVertices);
+	// src_vertices points to the raw GX vertices of this primitive, each vertex_size bytes.
+	// Pass nullptr when they don't match the decoded ones, e.g. because some were skipped.
+	static void AddIndices(int primitive, u32 numVertices, const u8* src_vertices, u32 vertex_size);
 
 	// returns numprimitives
 	static u32 GetNumVerts() {return base_index;}
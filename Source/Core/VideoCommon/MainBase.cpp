@@ -132,6 +132,7 @@ void VideoBackendHardware::Video_EndField()
 			Common::YieldCPU();
 		}
 		s_swapRequested.Set();
+		WakeGpuThread();
 	}
 }
 
@@ -181,6 +182,7 @@ u32 VideoBackendHardware::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32
 			if (s_FifoShuttingDown.IsSet())
 				return 0;
 			s_efbAccessRequested.Set();
+			WakeGpuThread();
 			s_efbAccessReadyEvent.Wait();
 		}
 		else
@@ -220,6 +222,7 @@ u32 VideoBackendHardware::Video_GetQueryResult(PerfQueryType type)
 			if (s_FifoShuttingDown.IsSet())
 				return 0;
 			s_perfQueryRequested.Set();
+			WakeGpuThread();
 			s_perfQueryReadyEvent.Wait();
 		}
 		else
@@ -243,6 +246,7 @@ u16 VideoBackendHardware::Video_GetBoundingBox(int index)
 			return 0;
 		s_BBoxIndex = index;
 		s_BBoxRequested.Set();
+		WakeGpuThread();
 		s_BBoxReadyEvent.Wait();
 		return s_BBoxResult;
 	}
@@ -288,6 +292,16 @@ void VideoBackendHardware::DoState(PointerWrap& p)
 		p.SetMode(PointerWrap::MODE_VERIFY);
 	}
 
+	// Deferred EFB copies have to be in the RAM that is saved, and must not end up in the RAM
+	// that is loaded. In dual core mode the GPU thread has already flushed them when pausing.
+	if (g_texture_cache)
+	{
+		if (p.GetMode() == PointerWrap::MODE_READ)
+			g_texture_cache->DiscardEFBCopies();
+		else
+			g_texture_cache->FlushEFBCopies();
+	}
+
 	VideoCommon_DoState(p);
 	p.DoMarker("VideoCommon");
 
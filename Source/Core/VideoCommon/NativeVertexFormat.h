@@ -12,6 +12,7 @@
 // m_components
 enum
 {
+	VB_HAS_DRAWIDX   =(1<<0), // posmtx holds a draw matrix slot, see VertexShaderManager::SetDrawMatrix
 	VB_HAS_POSMTXIDX =(1<<1),
 	VB_HAS_TEXMTXIDX0=(1<<2),
 	VB_HAS_TEXMTXIDX1=(1<<3),
@@ -17,6 +17,7 @@ bool PixelShaderManager::s_bViewPortChanged;
 
 PixelShaderConstants PixelShaderManager::constants;
 bool PixelShaderManager::dirty;
+bool PixelShaderManager::uid_dirty;
 
 void PixelShaderManager::Init()
 {
@@ -41,6 +42,7 @@ void PixelShaderManager::Init()
 	SetTexCoordChanged(7);
 
 	dirty = true;
+	uid_dirty = true;
 }
 
 void PixelShaderManager::Dirty()
@@ -53,6 +55,7 @@ void PixelShaderManager::Dirty()
 	SetFogParamChanged();
 
 	dirty = true;
+	uid_dirty = true;
 }
 
 void PixelShaderManager::Shutdown()
@@ -50,6 +50,10 @@ public:
 	static PixelShaderConstants constants;
 	static bool dirty;
 
+	// Set whenever state feeding the shader uid changes, so the backend only
+	// has to regenerate the uid when this is set.
+	static bool uid_dirty;
+
 	static bool s_bFogRangeAdjustChanged;
 	static bool s_bViewPortChanged;
 };
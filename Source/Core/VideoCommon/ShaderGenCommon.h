@@ -303,6 +303,7 @@ static inline void AssignVSOutputMembers(T& object, const char* a, const char* b
 #define I_NORMALMATRICES        "cnmtx"
 #define I_POSTTRANSFORMMATRICES "cpostmtx"
 #define I_PIXELCENTERCORRECTION "cpixelcenter"
+#define I_DRAWMATRICES          "cdrawmtx"
 
 #define I_STEREOPARAMS  "cstereo"
 #define I_LINEPTPARAMS  "clinept"
@@ -317,4 +318,5 @@ static const char s_shader_uniforms[] =
 	"\tfloat4 " I_TRANSFORMMATRICES"[64];\n"
 	"\tfloat4 " I_NORMALMATRICES"[32];\n"
 	"\tfloat4 " I_POSTTRANSFORMMATRICES"[64];\n"
-	"\tfloat4 " I_PIXELCENTERCORRECTION";\n";
+	"\tfloat4 " I_PIXELCENTERCORRECTION";\n"
+	"\tfloat4 " I_DRAWMATRICES"[192];\n";
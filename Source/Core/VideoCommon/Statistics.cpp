@@ -30,12 +30,19 @@ std::string Statistics::ToString()
 	str += StringFromFormat("Textures created: %i\n", stats.numTexturesCreated);
 	str += StringFromFormat("Textures uploaded: %i\n", stats.numTexturesUploaded);
 	str += StringFromFormat("Textures alive: %i\n", stats.numTexturesAlive);
+	str += StringFromFormat("Textures reused: %i\n", stats.numTexturesReused);
+	str += StringFromFormat("Textures evicted: %i\n", stats.numTexturesEvicted);
+	str += StringFromFormat("Texture memory: %i kB\n", stats.textureMemoryResidentKB);
 	str += StringFromFormat("pshaders created: %i\n", stats.numPixelShadersCreated);
 	str += StringFromFormat("pshaders alive: %i\n", stats.numPixelShadersAlive);
 	str += StringFromFormat("vshaders created: %i\n", stats.numVertexShadersCreated);
 	str += StringFromFormat("vshaders alive: %i\n", stats.numVertexShadersAlive);
+	str += StringFromFormat("shaders compiling: %i\n", stats.numShaderCompilesPending);
 	str += StringFromFormat("shaders changes: %i\n", stats.thisFrame.numShaderChanges);
 	str += StringFromFormat("dlists called: %i\n", stats.thisFrame.numDListsCalled);
+	str += StringFromFormat("GPU thread wakeups: %i (avg %i us, max %i us)\n", stats.thisFrame.numGpuThreadWakeups,
+		stats.thisFrame.numGpuThreadWakeups ? stats.thisFrame.gpuWakeupLatencyTotalUs / stats.thisFrame.numGpuThreadWakeups : 0,
+		stats.thisFrame.gpuWakeupLatencyMaxUs);
 	str += StringFromFormat("Primitive joins: %i\n", stats.thisFrame.numPrimitiveJoins);
 	str += StringFromFormat("Draw calls: %i\n", stats.thisFrame.numDrawCalls);
 	str += StringFromFormat("Primitives: %i\n", stats.thisFrame.numPrims);
@@ -49,6 +56,11 @@ std::string Statistics::ToString()
 	str += StringFromFormat("Vertex streamed: %i kB\n", stats.thisFrame.bytesVertexStreamed/1024);
 	str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed/1024);
 	str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed/1024);
+	str += StringFromFormat("EFB copies deferred: %i\n", stats.thisFrame.numEFBCopiesDeferred);
+	str += StringFromFormat("EFB peeks: %i (%i from previous frame)\n", stats.thisFrame.numEFBPeeks,
+		stats.thisFrame.numEFBPeeksAsync);
+	str += StringFromFormat("Stream buffer stalls: %i (%i us)\n", stats.thisFrame.numStreamBufferStalls,
+		stats.thisFrame.streamBufferStallTimeUs);
 	str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
 
 	std::string vertex_list;
@@ -16,10 +16,14 @@ struct Statistics
 	int numPixelShadersAlive;
 	int numVertexShadersCreated;
 	int numVertexShadersAlive;
+	int numShaderCompilesPending;
 
 	int numTexturesCreated;
 	int numTexturesUploaded;
 	int numTexturesAlive;
+	int numTexturesReused;
+	int numTexturesEvicted;
+	int textureMemoryResidentKB;
 
 	int numVertexLoaders;
 
@@ -51,9 +55,21 @@ struct Statistics
 
 		int numDListsCalled;
 
+		int numGpuThreadWakeups;
+		int gpuWakeupLatencyTotalUs;
+		int gpuWakeupLatencyMaxUs;
+
 		int bytesVertexStreamed;
 		int bytesIndexStreamed;
 		int bytesUniformStreamed;
+
+		int numEFBCopiesDeferred;
+
+		int numEFBPeeks;
+		int numEFBPeeksAsync;
+
+		int numStreamBufferStalls;
+		int streamBufferStallTimeUs;
 	};
 	ThisFrame thisFrame;
 	void ResetFrame();
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "Common/FileUtil.h"
 #include "Common/MemoryUtil.h"
@@ -175,6 +176,63 @@ void TextureCache::Cleanup(int _frameCount)
 			++iter2;
 		}
 	}
+
+	EnforceMemoryBudget(_frameCount);
+}
+
+// Frees textures until the cache fits into the configured amount of video memory.
+// Unused textures in the pool go first, then the least recently used cached textures.
+// EFB copies and textures used in the current frame are never evicted.
+void TextureCache::EnforceMemoryBudget(int _frameCount)
+{
+	u64 resident = 0;
+	for (const auto& tex : textures)
+		resident += tex.second->config.GetSizeInBytes();
+	for (const auto& rt : texture_pool)
+		resident += rt.second->config.GetSizeInBytes();
+
+	const u64 budget = (u64)g_ActiveConfig.iTextureCacheBudget << 20;
+	if (budget && resident > budget)
+	{
+		std::vector<TexPool::iterator> pool_entries;
+		for (auto iter = texture_pool.begin(); iter != texture_pool.end(); ++iter)
+			pool_entries.push_back(iter);
+		std::sort(pool_entries.begin(), pool_entries.end(), [](const TexPool::iterator& a, const TexPool::iterator& b) {
+			return a->second->frameCount < b->second->frameCount;
+		});
+
+		for (auto& iter : pool_entries)
+		{
+			if (resident <= budget)
+				break;
+			resident -= iter->second->config.GetSizeInBytes();
+			delete iter->second;
+			texture_pool.erase(iter);
+			INCSTAT(stats.numTexturesEvicted);
+		}
+
+		std::vector<TexCache::iterator> cache_entries;
+		for (auto iter = textures.begin(); iter != textures.end(); ++iter)
+		{
+			if (!iter->second->IsEfbCopy() && iter->second->frameCount < _frameCount)
+				cache_entries.push_back(iter);
+		}
+		std::sort(cache_entries.begin(), cache_entries.end(), [](const TexCache::iterator& a, const TexCache::iterator& b) {
+			return a->second->frameCount < b->second->frameCount;
+		});
+
+		for (auto& iter : cache_entries)
+		{
+			if (resident <= budget)
+				break;
+			resident -= iter->second->config.GetSizeInBytes();
+			delete iter->second;
+			textures.erase(iter);
+			INCSTAT(stats.numTexturesEvicted);
+		}
+	}
+
+	SETSTAT(stats.textureMemoryResidentKB, resident >> 10);
 }
 
 void TextureCache::MakeRangeDynamic(u32 start_address, u32 size)
@@ -302,7 +360,10 @@ TextureCache::TCacheEntryBase* TextureCache::Load(const u32 stage)
 	if (from_tmem)
 		src_data = &texMem[bpmem.tex[stage / 4].texImage1[stage % 4].tmem_even * TMEM_LINE_SIZE];
 	else
+	{
+		g_texture_cache->FlushEFBCopiesInRange(address, texture_size);
 		src_data = Memory::GetPointer(address);
+	}
 
 	// TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data from the low tmem bank than it should)
 	tex_hash = GetHash64(src_data, texture_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
@@ -885,6 +946,7 @@ TextureCache::TCacheEntryBase* TextureCache::AllocateTexture(const TCacheEntryCo
 	{
 		TextureCache::TCacheEntryBase* entry = iter->second;
 		texture_pool.erase(iter);
+		INCSTAT(stats.numTexturesReused);
 		return entry;
 	}
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <unordered_map>
@@ -28,6 +29,15 @@ public:
 		u32 levels, layers;
 		bool rendertarget;
 
+		// Approximate amount of video memory used by a texture with this config
+		u64 GetSizeInBytes() const
+		{
+			u64 size = 0;
+			for (u32 level = 0; level < levels; ++level)
+				size += (u64)std::max(1u, width >> level) * std::max(1u, height >> level) * 4;
+			return size * layers;
+		}
+
 		bool operator == (const TCacheEntryConfig& b) const
 		{
 			return width == b.width && height == b.height && levels == b.levels && layers == b.layers && rendertarget == b.rendertarget;
@@ -122,6 +132,13 @@ public:
 
 	static void RequestInvalidateTextureCache();
 
+	// Writes EFB copies which are still being read back from the GPU to RAM.
+	// Only needed by backends which defer the readback of EFB copies to RAM.
+	virtual void FlushEFBCopies() {}
+	virtual void FlushEFBCopiesInRange(u32 address, u32 size) {}
+	// Drops them instead, when the RAM they were made for is replaced by a savestate.
+	virtual void DiscardEFBCopies() {}
+
 	virtual void ConvertTexture(TCacheEntryBase* entry, TCacheEntryBase* unconverted, void* palette, TlutFormat format) = 0;
 
 protected:
@@ -138,6 +155,7 @@ private:
 	static void FreeTexture(TCacheEntryBase* entry);
 
 	static TCacheEntryBase* ReturnEntry(unsigned int stage, TCacheEntryBase* entry);
+	static void EnforceMemoryBudget(int _frameCount);
 
 	typedef std::multimap<u32, TCacheEntryBase*> TexCache;
 	typedef std::unordered_multimap<TCacheEntryConfig, TCacheEntryBase*, TCacheEntryConfig::Hasher> TexPool;
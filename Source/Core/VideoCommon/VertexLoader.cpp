@@ -15,6 +15,7 @@
 #include "VideoCommon/VertexLoader_Normal.h"
 #include "VideoCommon/VertexLoader_Position.h"
 #include "VideoCommon/VertexLoader_TextCoord.h"
+#include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -29,6 +30,11 @@ static void LOADERDECL PosMtx_ReadDirect_UByte(VertexLoader* loader)
 	PRIM_LOG("posmtx: %d, ", posmtx);
 }
 
+static void LOADERDECL DrawMtx_Write_U32(VertexLoader* loader)
+{
+	DataWrite<u32>(VertexShaderManager::draw_matrix_slot);
+}
+
 static void LOADERDECL TexMtx_ReadDirect_UByte(VertexLoader* loader)
 {
 	BoundingBox::texMtxIdx[loader->m_texmtxread] = loader->m_curtexmtx[loader->m_texmtxread] = DataReadU8() & 0x3f;
@@ -104,10 +110,20 @@ void VertexLoader::CompileVertexTranslator()
 	// Position in pc vertex format.
 	int nat_offset = 0;
 
-	// Position Matrix Index
-	if (m_VtxDesc.PosMatIdx)
+	// Position Matrix Index, without one batched draws store their draw matrix slot there
+	bool draw_matrix = !m_VtxDesc.PosMatIdx && VertexShaderManager::draw_matrix_batching;
+	if (m_VtxDesc.PosMatIdx || draw_matrix)
 	{
-		WriteCall(PosMtx_ReadDirect_UByte);
+		if (draw_matrix)
+		{
+			WriteCall(DrawMtx_Write_U32);
+			components |= VB_HAS_DRAWIDX;
+		}
+		else
+		{
+			WriteCall(PosMtx_ReadDirect_UByte);
+			m_VertexSize += 1;
+		}
 		components |= VB_HAS_POSMTXIDX;
 		m_native_vtx_decl.posmtx.components = 4;
 		m_native_vtx_decl.posmtx.enable = true;
@@ -115,7 +131,6 @@ void VertexLoader::CompileVertexTranslator()
 		m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
 		m_native_vtx_decl.posmtx.integer = true;
 		nat_offset += 4;
-		m_VertexSize += 1;
 	}
 
 	if (m_VtxDesc.Tex0MatIdx) {m_VertexSize += 1; components |= VB_HAS_TEXMTXIDX0; WriteCall(TexMtx_ReadDirect_UByte); }
@@ -321,7 +336,6 @@ int VertexLoader::RunVertices(DataReader src, DataReader dst, int count, int pri
 	g_vertex_manager_write_ptr = dst.GetPointer();
 	g_video_buffer_read_ptr = src.GetPointer();
 
-	m_numLoadedVertices += count;
 	m_skippedVertices = 0;
 
 	// Prepare bounding box
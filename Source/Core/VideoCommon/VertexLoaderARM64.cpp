@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "VideoCommon/VertexLoaderARM64.h"
+#include "VideoCommon/VertexShaderManager.h"
 
 using namespace Arm64Gen;
 
@@ -336,10 +337,22 @@ void VertexLoaderARM64::GenerateVertexLoader()
 
 	const u8* loop_start = GetCodePtr();
 
-	if (m_VtxDesc.PosMatIdx)
+	// Without a matrix index, batched draws store their draw matrix slot there.
+	bool draw_matrix = !m_VtxDesc.PosMatIdx && VertexShaderManager::draw_matrix_batching;
+	if (m_VtxDesc.PosMatIdx || draw_matrix)
 	{
-		LDRB(INDEX_UNSIGNED, scratch1_reg, src_reg, m_src_ofs);
-		AND(scratch1_reg, scratch1_reg, 0, 5);
+		if (draw_matrix)
+		{
+			MOVI2R(EncodeRegTo64(scratch1_reg), (u64)&VertexShaderManager::draw_matrix_slot);
+			LDR(INDEX_UNSIGNED, scratch1_reg, EncodeRegTo64(scratch1_reg), 0);
+			m_native_components |= VB_HAS_DRAWIDX;
+		}
+		else
+		{
+			LDRB(INDEX_UNSIGNED, scratch1_reg, src_reg, m_src_ofs);
+			AND(scratch1_reg, scratch1_reg, 0, 5);
+			m_src_ofs += sizeof(u8);
+		}
 		STR(INDEX_UNSIGNED, scratch1_reg, dst_reg, m_dst_ofs);
 		m_native_components |= VB_HAS_POSMTXIDX;
 		m_native_vtx_decl.posmtx.components = 4;
@@ -347,7 +360,6 @@ void VertexLoaderARM64::GenerateVertexLoader()
 		m_native_vtx_decl.posmtx.offset = m_dst_ofs;
 		m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
 		m_native_vtx_decl.posmtx.integer = true;
-		m_src_ofs += sizeof(u8);
 		m_dst_ofs += sizeof(u32);
 	}
 
@@ -536,6 +548,5 @@ void VertexLoaderARM64::GenerateVertexLoader()
 
 int VertexLoaderARM64::RunVertices(DataReader src, DataReader dst, int count, int primitive)
 {
-	m_numLoadedVertices += count;
 	return ((int (*)(u8* src, u8* dst, int count))region)(src.GetPointer(), dst.GetPointer(), count);
 }
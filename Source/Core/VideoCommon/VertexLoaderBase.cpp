@@ -5,6 +5,7 @@
 #include <cinttypes>
 #include <vector>
 
+#include "Common/BitSet.h"
 #include "Common/StringUtil.h"
 
 #include "VideoCommon/VertexLoader.h"
@@ -29,6 +30,22 @@ VertexLoaderBase::VertexLoaderBase(const TVtxDesc &vtx_desc, const VAT &vtx_attr
 	m_vat = vtx_attr;
 }
 
+int VertexLoaderBase::CountSkippedVertices(const u8* src, int count) const
+{
+	if (m_VtxDesc.Position != INDEX8 && m_VtxDesc.Position != INDEX16)
+		return 0;
+
+	// The position index follows the matrix indices, which are one byte each.
+	src += CountSetBits((u32)(m_VtxDesc.Hex & 0x1FF));
+	int skipped = 0;
+	for (int i = 0; i < count; ++i, src += m_VertexSize)
+	{
+		if (src[0] == 0xFF && (m_VtxDesc.Position == INDEX8 || src[1] == 0xFF))
+			skipped++;
+	}
+	return skipped;
+}
+
 void VertexLoaderBase::SetVAT(const VAT& vat)
 {
 	m_VtxAttr.PosElements          = vat.g0.PosElements;
@@ -178,7 +195,6 @@ public:
 			                 m_VtxDesc.Hex, m_vat.g0.Hex, m_vat.g1.Hex, m_vat.g2.Hex);
 
 		memcpy(dst.GetPointer(), buffer_a.data(), count_a * m_native_vtx_decl.stride);
-		m_numLoadedVertices += count;
 		return count_a;
 	}
 	std::string GetName() const override { return "CompareLoader"; }
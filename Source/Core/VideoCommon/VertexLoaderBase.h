@@ -78,6 +78,12 @@ public:
 
 	virtual bool IsInitialized() = 0;
 
+	// Whether RunVertices may be called for disjoint parts of a batch from several threads at once.
+	virtual bool SupportsParallelDecoding() const { return false; }
+
+	// Number of vertices RunVertices drops from src because their position index is -1.
+	int CountSkippedVertices(const u8* src, int count) const;
+
 	// For debugging / profiling
 	void AppendToString(std::string *dest) const;
 
@@ -3,13 +3,22 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cinttypes>
+#include <cstring>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "Common/CommonFuncs.h"
+#include "Common/CPUDetect.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Core/HW/Memmap.h"
 
 #include "VideoCommon/BPMemory.h"
@@ -20,6 +29,7 @@
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
 
 
 
@@ -35,6 +45,153 @@ static std::mutex s_vertex_loader_map_lock;
 static VertexLoaderMap s_vertex_loader_map;
 // TODO - change into array of pointers. Keep a map of all seen so far.
 
+// Large batches are split into chunks which are decoded by a pool of worker threads
+// and the GPU thread itself. The GPU thread waits for the whole batch, so draws are
+// still submitted in order.
+static const int MAX_DECODE_CHUNKS = 8;
+static const int MIN_DECODE_CHUNK_VERTICES = 2048;
+
+struct DecodeJob
+{
+	VertexLoaderBase* loader;
+	u8* src;
+	u8* dst;
+	int count;
+	int primitive;
+	int num_chunks;
+	int chunk_size;
+	std::atomic<int> next_chunk;
+	int chunks_done;
+	// Where each chunk's output starts, in vertices. Vertices with a position index of -1
+	// are dropped, so these are counted beforehand: dst is write-only to us.
+	int dst_offset[MAX_DECODE_CHUNKS];
+};
+
+static std::vector<std::thread> s_decode_threads;
+static std::mutex s_decode_mutex;
+static std::condition_variable s_decode_cv;
+static std::condition_variable s_decode_done_cv;
+static DecodeJob s_decode_job;
+static u32 s_decode_generation;
+static int s_decode_busy_threads;
+static bool s_decode_threads_running;
+
+static void DecodeChunks()
+{
+	DecodeJob& job = s_decode_job;
+	int chunk;
+	while ((chunk = job.next_chunk++) < job.num_chunks)
+	{
+		int first = chunk * job.chunk_size;
+		int count = std::min(job.chunk_size, job.count - first);
+		u32 vertex_size = job.loader->m_VertexSize;
+		u32 stride = job.loader->m_native_vtx_decl.stride;
+
+		u8* out = job.dst + job.dst_offset[chunk] * stride;
+
+		DataReader src(job.src + first * vertex_size, job.src + (first + count) * vertex_size);
+		DataReader dst(out, out + count * stride);
+		job.loader->RunVertices(src, dst, count, job.primitive);
+
+		std::lock_guard<std::mutex> lk(s_decode_mutex);
+		if (++job.chunks_done == job.num_chunks)
+			s_decode_done_cv.notify_all();
+	}
+}
+
+static void DecodeThread()
+{
+	Common::SetCurrentThreadName("Vertex decoder");
+
+	u32 generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lk(s_decode_mutex);
+			s_decode_cv.wait(lk, [&] { return !s_decode_threads_running || s_decode_generation != generation; });
+			if (!s_decode_threads_running)
+				return;
+			generation = s_decode_generation;
+			s_decode_busy_threads++;
+		}
+
+		DecodeChunks();
+
+		std::lock_guard<std::mutex> lk(s_decode_mutex);
+		if (--s_decode_busy_threads == 0)
+			s_decode_done_cv.notify_all();
+	}
+}
+
+static void StartDecodeThreads()
+{
+	if (!g_ActiveConfig.bParallelVertexLoading)
+		return;
+
+	int num_threads = std::min(cpu_info.num_cores - 1, MAX_DECODE_CHUNKS - 1);
+	if (num_threads <= 0)
+		return;
+
+	s_decode_threads_running = true;
+	for (int i = 0; i < num_threads; i++)
+		s_decode_threads.emplace_back(DecodeThread);
+}
+
+static void StopDecodeThreads()
+{
+	{
+		std::lock_guard<std::mutex> lk(s_decode_mutex);
+		s_decode_threads_running = false;
+	}
+	s_decode_cv.notify_all();
+
+	for (std::thread& thread : s_decode_threads)
+		thread.join();
+	s_decode_threads.clear();
+}
+
+// Returns the number of vertices written, like VertexLoaderBase::RunVertices.
+static int RunVerticesParallel(VertexLoaderBase* loader, DataReader src, DataReader dst, int count, int primitive)
+{
+	DecodeJob& job = s_decode_job;
+	int num_chunks = std::min<int>(s_decode_threads.size() + 1, count / MIN_DECODE_CHUNK_VERTICES);
+	int written = 0;
+
+	{
+		// Workers which woke up late may still be looking at the previous job.
+		std::unique_lock<std::mutex> lk(s_decode_mutex);
+		s_decode_done_cv.wait(lk, [] { return s_decode_busy_threads == 0; });
+
+		job.loader = loader;
+		job.src = src.GetPointer();
+		job.dst = dst.GetPointer();
+		job.count = count;
+		job.primitive = primitive;
+		job.num_chunks = num_chunks;
+		job.chunk_size = (count + num_chunks - 1) / num_chunks;
+		for (int chunk = 0; chunk < num_chunks; chunk++)
+		{
+			int first = chunk * job.chunk_size;
+			int chunk_count = std::min(job.chunk_size, count - first);
+			job.dst_offset[chunk] = written;
+			written += chunk_count - loader->CountSkippedVertices(job.src + first * loader->m_VertexSize, chunk_count);
+		}
+		job.next_chunk = 0;
+		job.chunks_done = 0;
+		s_decode_generation++;
+	}
+	s_decode_cv.notify_all();
+
+	DecodeChunks();
+
+	{
+		std::unique_lock<std::mutex> lk(s_decode_mutex);
+		s_decode_done_cv.wait(lk, [&] { return job.chunks_done == job.num_chunks; });
+	}
+
+	return written;
+}
+
 void Init()
 {
 	MarkAllDirty();
@@ -43,10 +200,13 @@ void Init()
 	for (auto& map_entry : g_preprocess_cp_state.vertex_loaders)
 		map_entry = nullptr;
 	RecomputeCachedArraybases();
+	StartDecodeThreads();
 }
 
 void Shutdown()
 {
+	StopDecodeThreads();
+
 	std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
 	s_vertex_loader_map.clear();
 	s_native_vertex_map.clear();
@@ -70,6 +230,10 @@ void AppendListToString(std::string *dest)
 	std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
 	std::vector<entry> entries;
 
+	// Which implementation the vertex formats ended up with, the generic
+	// loader is a lot slower than the JIT ones.
+	std::map<std::string, std::pair<u32, u64>> implementations;
+
 	size_t total_size = 0;
 	for (const auto& map_entry : s_vertex_loader_map)
 	{
@@ -78,9 +242,18 @@ void AppendListToString(std::string *dest)
 		e.num_verts = map_entry.second->m_numLoadedVertices;
 		entries.push_back(e);
 		total_size += e.text.size() + 1;
+
+		std::pair<u32, u64>& implementation = implementations[map_entry.second->GetName()];
+		implementation.first++;
+		implementation.second += e.num_verts;
 	}
 	sort(entries.begin(), entries.end());
 	dest->reserve(dest->size() + total_size);
+	for (const auto& implementation : implementations)
+	{
+		dest->append(StringFromFormat("%s: %u formats - %" PRIu64 " v\n", implementation.first.c_str(),
+		                              implementation.second.first, implementation.second.second));
+	}
 	for (const entry& entry : entries)
 	{
 		dest->append(entry.text);
@@ -157,6 +330,11 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
 		VertexManager::Flush();
 	s_current_vtx_fmt = loader->m_native_vertex_format;
 
+	// This may flush when there are no free matrix slots, so it must come before
+	// PrepareForAdditionalData.
+	if (VertexShaderManager::draw_matrix_batching)
+		VertexShaderManager::SetDrawMatrix(loader->m_native_components);
+
 	// if cull mode is CULL_ALL, tell VertexManager to skip triangles and quads.
 	// They still need to go through vertex loading, because we need to calculate a zfreeze refrence slope.
 	bool cullall = (bpmem.genMode.cullmode == GenMode::CULL_ALL && primitive < 5);
@@ -164,13 +342,19 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
 	DataReader dst = VertexManager::PrepareForAdditionalData(primitive, count,
 			loader->m_native_vtx_decl.stride, cullall);
 
-	count = loader->RunVertices(src, dst, count, primitive);
+	loader->m_numLoadedVertices += count;
+	int loaded;
+	if (!s_decode_threads.empty() && count >= 2 * MIN_DECODE_CHUNK_VERTICES && loader->SupportsParallelDecoding())
+		loaded = RunVerticesParallel(loader, src, dst, count, primitive);
+	else
+		loaded = loader->RunVertices(src, dst, count, primitive);
 
-	IndexGenerator::AddIndices(primitive, count);
+	// Skipped vertices leave the raw ones out of step with the decoded ones.
+	IndexGenerator::AddIndices(primitive, loaded, loaded == count ? src.GetPointer() : nullptr, loader->m_VertexSize);
 
-	VertexManager::FlushData(count, loader->m_native_vtx_decl.stride);
+	VertexManager::FlushData(loaded, loader->m_native_vtx_decl.stride);
 
-	ADDSTAT(stats.thisFrame.numPrims, count);
+	ADDSTAT(stats.thisFrame.numPrims, loaded);
 	INCSTAT(stats.thisFrame.numPrimitiveJoins);
 	return size;
 }
@@ -8,6 +8,7 @@
 #include "Common/JitRegister.h"
 #include "Common/x64ABI.h"
 #include "VideoCommon/VertexLoaderX64.h"
+#include "VideoCommon/VertexShaderManager.h"
 
 using namespace Gen;
 
@@ -69,7 +70,7 @@ OpArg VertexLoaderX64::GetVertexAddr(int array, u64 attribute)
 	}
 }
 
-int VertexLoaderX64::ReadVertex(OpArg data, u64 attribute, int format, int count_in, int count_out, bool dequantize, u8 scaling_exponent, AttributeFormat* native_format)
+int VertexLoaderX64::ReadVertex(OpArg data, u64 attribute, int format, int count_in, int count_out, bool dequantize, u8 scaling_exponent, AttributeFormat* native_format, bool last_attribute)
 {
 	static const __m128i shuffle_lut[5][3] = {
 		{_mm_set_epi32(0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFFFFL, 0xFFFFFF00L),  // 1x u8
@@ -131,7 +132,19 @@ int VertexLoaderX64::ReadVertex(OpArg data, u64 attribute, int format, int count
 	{
 		case 1: MOVSS(dest, coords); break;
 		case 2: MOVLPS(dest, coords); break;
-		case 3: MOVUPS(dest, coords); break;
+		case 3:
+			if (last_attribute)
+			{
+				// Don't spill into the next vertex.
+				MOVLPS(dest, coords);
+				MOVHLPS(coords, coords);
+				MOVSS(MDisp(dst_reg, m_dst_ofs + 8), coords);
+			}
+			else
+			{
+				MOVUPS(dest, coords);
+			}
+			break;
 	}
 
 	native_format->components = count_out;
@@ -310,18 +323,23 @@ void VertexLoaderX64::GenerateVertexLoader()
 
 	const u8* loop_start = GetCodePtr();
 
-	if (m_VtxDesc.PosMatIdx)
+	// The matrix index is stored after the position, so that skipped vertices don't
+	// write anything. Parallel decoding places the next vertex right behind them.
+	// Without a matrix index, batched draws store their draw matrix slot there.
+	u32 posmtx_src_ofs = m_src_ofs;
+	bool draw_matrix = !m_VtxDesc.PosMatIdx && VertexShaderManager::draw_matrix_batching;
+	if (m_VtxDesc.PosMatIdx || draw_matrix)
 	{
-		MOVZX(32, 8, scratch1, MDisp(src_reg, m_src_ofs));
-		AND(32, R(scratch1), Imm8(0x3F));
-		MOV(32, MDisp(dst_reg, m_dst_ofs), R(scratch1));
+		if (draw_matrix)
+			m_native_components |= VB_HAS_DRAWIDX;
+		else
+			m_src_ofs += sizeof(u8);
 		m_native_components |= VB_HAS_POSMTXIDX;
 		m_native_vtx_decl.posmtx.components = 4;
 		m_native_vtx_decl.posmtx.enable = true;
 		m_native_vtx_decl.posmtx.offset = m_dst_ofs;
 		m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
 		m_native_vtx_decl.posmtx.integer = true;
-		m_src_ofs += sizeof(u8);
 		m_dst_ofs += sizeof(u32);
 	}
 
@@ -336,16 +354,47 @@ void VertexLoaderX64::GenerateVertexLoader()
 			texmatidx_ofs[i] = m_src_ofs++;
 	}
 
+	const u64 tc[8] = {
+		m_VtxDesc.Tex0Coord, m_VtxDesc.Tex1Coord, m_VtxDesc.Tex2Coord, m_VtxDesc.Tex3Coord,
+		m_VtxDesc.Tex4Coord, m_VtxDesc.Tex5Coord, m_VtxDesc.Tex6Coord, m_VtxDesc.Tex7Coord,
+	};
+	const u64 col[2] = {m_VtxDesc.Color0, m_VtxDesc.Color1};
+
+	// Vector stores write 16 bytes even for 3 components. That's fine in the middle of
+	// a vertex, but the last store must not touch the next vertex: with parallel
+	// decoding, it may belong to another thread.
+	int last_texcoord = -1;
+	for (int i = 0; i < 8; i++)
+	{
+		if (tc[i] || tm[i])
+			last_texcoord = i;
+	}
+	bool last_normal = last_texcoord < 0 && !col[0] && !col[1];
+	bool last_position = last_normal && !m_VtxDesc.Normal;
+
 	OpArg data = GetVertexAddr(ARRAY_POSITION, m_VtxDesc.Position);
 	ReadVertex(data, m_VtxDesc.Position, m_VtxAttr.PosFormat, m_VtxAttr.PosElements + 2, 3,
-	           m_VtxAttr.ByteDequant, m_VtxAttr.PosFrac, &m_native_vtx_decl.position);
+	           m_VtxAttr.ByteDequant, m_VtxAttr.PosFrac, &m_native_vtx_decl.position, last_position);
+
+	if (m_VtxDesc.PosMatIdx)
+	{
+		MOVZX(32, 8, scratch1, MDisp(src_reg, posmtx_src_ofs));
+		AND(32, R(scratch1), Imm8(0x3F));
+		MOV(32, MDisp(dst_reg, m_native_vtx_decl.posmtx.offset), R(scratch1));
+	}
+	else if (draw_matrix)
+	{
+		MOV(32, R(scratch1), M(&VertexShaderManager::draw_matrix_slot));
+		MOV(32, MDisp(dst_reg, m_native_vtx_decl.posmtx.offset), R(scratch1));
+	}
 
 	if (m_VtxDesc.Normal)
 	{
 		static const u8 map[8] = {7, 6, 15, 14};
 		u8 scaling_exponent = map[m_VtxAttr.NormalFormat];
 
-		for (int i = 0; i < (m_VtxAttr.NormalElements ? 3 : 1); i++)
+		int num_normals = m_VtxAttr.NormalElements ? 3 : 1;
+		for (int i = 0; i < num_normals; i++)
 		{
 			if (!i || m_VtxAttr.NormalIndex3)
 			{
@@ -353,8 +402,8 @@ void VertexLoaderX64::GenerateVertexLoader()
 				int elem_size = 1 << (m_VtxAttr.NormalFormat / 2);
 				data.offset += i * elem_size * 3;
 			}
-			data.offset += ReadVertex(data, m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 3, 3,
-			                          true, scaling_exponent, &m_native_vtx_decl.normals[i]);
+			data.offset += ReadVertex(data, m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 3, 3, true, scaling_exponent,
+			                          &m_native_vtx_decl.normals[i], last_normal && i == num_normals - 1);
 		}
 
 		m_native_components |= VB_HAS_NRM0;
@@ -362,7 +411,6 @@ void VertexLoaderX64::GenerateVertexLoader()
 			m_native_components |= VB_HAS_NRM1 | VB_HAS_NRM2;
 	}
 
-	const u64 col[2] = {m_VtxDesc.Color0, m_VtxDesc.Color1};
 	for (int i = 0; i < 2; i++)
 	{
 		if (col[i])
@@ -379,10 +427,6 @@ void VertexLoaderX64::GenerateVertexLoader()
 		}
 	}
 
-	const u64 tc[8] = {
-		m_VtxDesc.Tex0Coord, m_VtxDesc.Tex1Coord, m_VtxDesc.Tex2Coord, m_VtxDesc.Tex3Coord,
-		m_VtxDesc.Tex4Coord, m_VtxDesc.Tex5Coord, m_VtxDesc.Tex6Coord, m_VtxDesc.Tex7Coord,
-	};
 	for (int i = 0; i < 8; i++)
 	{
 		int elements = m_VtxAttr.texCoord[i].Elements + 1;
@@ -391,7 +435,7 @@ void VertexLoaderX64::GenerateVertexLoader()
 			data = GetVertexAddr(ARRAY_TEXCOORD0 + i, tc[i]);
 			u8 scaling_exponent = m_VtxAttr.texCoord[i].Frac;
 			ReadVertex(data, tc[i], m_VtxAttr.texCoord[i].Format, elements, tm[i] ? 2 : elements,
-			           m_VtxAttr.ByteDequant, scaling_exponent, &m_native_vtx_decl.texcoords[i]);
+			           m_VtxAttr.ByteDequant, scaling_exponent, &m_native_vtx_decl.texcoords[i], i == last_texcoord);
 			m_native_components |= VB_HAS_UV0 << i;
 		}
 		if (tm[i])
@@ -414,7 +458,16 @@ void VertexLoaderX64::GenerateVertexLoader()
 				PXOR(XMM0, R(XMM0));
 				CVTSI2SS(XMM0, R(scratch1));
 				SHUFPS(XMM0, R(XMM0), 0x45);
-				MOVUPS(MDisp(dst_reg, m_dst_ofs), XMM0);
+				if (i == last_texcoord)
+				{
+					MOVLPS(MDisp(dst_reg, m_dst_ofs), XMM0);
+					MOVHLPS(XMM0, XMM0);
+					MOVSS(MDisp(dst_reg, m_dst_ofs + 8), XMM0);
+				}
+				else
+				{
+					MOVUPS(MDisp(dst_reg, m_dst_ofs), XMM0);
+				}
 				m_dst_ofs += sizeof(float) * 3;
 			}
 		}
@@ -459,6 +512,5 @@ bool VertexLoaderX64::IsInitialized()
 
 int VertexLoaderX64::RunVertices(DataReader src, DataReader dst, int count, int primitive)
 {
-	m_numLoadedVertices += count;
 	return ((int (*)(u8* src, u8* dst, int count))region)(src.GetPointer(), dst.GetPointer(), count);
 }
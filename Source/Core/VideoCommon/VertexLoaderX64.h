@@ -9,6 +9,8 @@ public:
 protected:
 	std::string GetName() const override { return "VertexLoaderX64"; }
 	bool IsInitialized() override;
+	// The generated code only reads the global array state.
+	bool SupportsParallelDecoding() const override { return true; }
 	int RunVertices(DataReader src, DataReader dst, int count, int primitive) override;
 
 private:
@@ -16,7 +18,7 @@ private:
 	u32 m_dst_ofs = 0;
 	Gen::FixupBranch m_skip_vertex;
 	Gen::OpArg GetVertexAddr(int array, u64 attribute);
-	int ReadVertex(Gen::OpArg data, u64 attribute, int format, int count_in, int count_out, bool dequantize, u8 scaling_exponent, AttributeFormat* native_format);
+	int ReadVertex(Gen::OpArg data, u64 attribute, int format, int count_in, int count_out, bool dequantize, u8 scaling_exponent, AttributeFormat* native_format, bool last_attribute);
 	void ReadColor(Gen::OpArg data, u64 attribute, int format);
 	void GenerateVertexLoader();
 };
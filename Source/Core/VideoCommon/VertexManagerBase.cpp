@@ -44,6 +44,9 @@ static const PrimitiveType primitive_from_gx[8] = {
 
 VertexManager::VertexManager()
 {
+	if (VertexShaderManager::draw_matrix_batching)
+		VertexShaderManager::ResetDrawMatrices();
+
 	s_is_flushed = true;
 	s_cull_all = false;
 }
@@ -307,7 +310,11 @@ void VertexManager::CalculateZSlope(NativeVertexFormat* format)
 		if(vert_decl.posmtx.enable)
 			mtxIdx = *((u32*)(vtx_ptr + mtxOff));
 
-		VertexShaderManager::TransformToClipSpace(&vtx[i * 3], &out[i * 4], mtxIdx);
+		// Batched draws store the slot of their matrix snapshot instead.
+		if (format->m_components & VB_HAS_DRAWIDX)
+			VertexShaderManager::TransformToClipSpace(&vtx[i * 3], &out[i * 4], VertexShaderManager::GetDrawMatrix(mtxIdx));
+		else
+			VertexShaderManager::TransformToClipSpace(&vtx[i * 3], &out[i * 4], mtxIdx);
 
 		// Transform to Screenspace
 		float inv_w = 1.0f / out[3 + i * 4];
@@ -133,7 +133,15 @@ static inline void GenerateVertexShader(T& out, u32 components, API_TYPE api_typ
 	// transforms
 	if (components & VB_HAS_POSMTXIDX)
 	{
-		if (is_writing_shadercode && (DriverDetails::HasBug(DriverDetails::BUG_NODYNUBOACCESS) && !DriverDetails::HasBug(DriverDetails::BUG_ANNIHILATEDUBOS)) )
+		if (components & VB_HAS_DRAWIDX)
+		{
+			// Batched draw: posmtx selects the matrices the draw was issued with.
+			out.Write("int drawidx = posmtx * 6;\n");
+			out.Write("float4 pos = float4(dot(" I_DRAWMATRICES"[drawidx], rawpos), dot(" I_DRAWMATRICES"[drawidx+1], rawpos), dot(" I_DRAWMATRICES"[drawidx+2], rawpos), 1);\n");
+			if (components & VB_HAS_NRMALL)
+				out.Write("float3 N0 = " I_DRAWMATRICES"[drawidx+3].xyz, N1 = " I_DRAWMATRICES"[drawidx+4].xyz, N2 = " I_DRAWMATRICES"[drawidx+5].xyz;\n");
+		}
+		else if (is_writing_shadercode && (DriverDetails::HasBug(DriverDetails::BUG_NODYNUBOACCESS) && !DriverDetails::HasBug(DriverDetails::BUG_ANNIHILATEDUBOS)) )
 		{
 			// This'll cause issues, but  it can't be helped
 			out.Write("float4 pos = float4(dot(" I_TRANSFORMMATRICES"[0], rawpos), dot(" I_TRANSFORMMATRICES"[1], rawpos), dot(" I_TRANSFORMMATRICES"[2], rawpos), 1);\n");
@@ -2,6 +2,7 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <sstream>
@@ -11,6 +12,8 @@
 #include "Common/MathUtil.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DriverDetails.h"
+#include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -30,6 +33,10 @@ static int nNormalMatricesChanged[2]; // min,max
 static int nPostTransformMatricesChanged[2]; // min,max
 static int nLightsChanged[2]; // min,max
 
+// draw matrix batching
+static u32 s_draw_matrix_slots_used;
+static bool s_draw_reads_xf_matrices, s_batch_reads_xf_matrices;
+
 static Matrix44 s_viewportCorrection;
 static Matrix33 s_viewRotationMatrix;
 static Matrix33 s_viewInvRotationMatrix;
@@ -38,6 +45,9 @@ static float s_fViewRotation[2];
 
 VertexShaderConstants VertexShaderManager::constants;
 bool VertexShaderManager::dirty;
+bool VertexShaderManager::uid_dirty;
+bool VertexShaderManager::draw_matrix_batching;
+u32 VertexShaderManager::draw_matrix_slot;
 
 struct ProjectionHack
 {
@@ -183,6 +193,13 @@ void VertexShaderManager::Init()
 	bProjectionChanged = true;
 	bViewportChanged = false;
 
+	// Batched draws index the matrix snapshots dynamically.
+	draw_matrix_batching = g_ActiveConfig.bDrawMatrixBatching && !DriverDetails::HasBug(DriverDetails::BUG_NODYNUBOACCESS);
+	draw_matrix_slot = 0;
+	s_draw_matrix_slots_used = 0;
+	s_draw_reads_xf_matrices = false;
+	s_batch_reads_xf_matrices = false;
+
 	memset(&xfmem, 0, sizeof(xfmem));
 	memset(&constants, 0 , sizeof(constants));
 	ResetView();
@@ -194,10 +211,12 @@ void VertexShaderManager::Init()
 		g_fProjectionMatrix[i*5] = 1.0f;
 
 	dirty = true;
+	uid_dirty = true;
 }
 
 void VertexShaderManager::Shutdown()
 {
+	draw_matrix_batching = false;
 }
 
 void VertexShaderManager::Dirty()
@@ -207,6 +226,7 @@ void VertexShaderManager::Dirty()
 	bProjectionChanged = true;
 
 	dirty = true;
+	uid_dirty = true;
 }
 
 // Syncs the shader constant buffers with xfmem
@@ -615,7 +635,9 @@ void VertexShaderManager::SetTexMatrixChangedA(u32 Value)
 {
 	if (g_main_cp_state.matrix_index_a.Hex != Value)
 	{
-		VertexManager::Flush();
+		// Batched draws have a snapshot of their position matrix
+		if (!draw_matrix_batching || ((g_main_cp_state.matrix_index_a.Hex ^ Value) & ~0x3f))
+			VertexManager::Flush();
 		if (g_main_cp_state.matrix_index_a.PosNormalMtxIdx != (Value&0x3f))
 			bPosNormalMatrixChanged = true;
 		bTexMatricesChanged[0] = true;
@@ -633,6 +655,78 @@ void VertexShaderManager::SetTexMatrixChangedB(u32 Value)
 	}
 }
 
+void VertexShaderManager::SetDrawMatrix(u32 components)
+{
+	// Per-vertex matrix indices read the xf matrices as they are when the batch is flushed.
+	s_draw_reads_xf_matrices = (components & VB_HAS_TEXMTXIDXALL) || !(components & VB_HAS_DRAWIDX);
+	s_batch_reads_xf_matrices |= s_draw_reads_xf_matrices;
+	if (!(components & VB_HAS_DRAWIDX))
+		return;
+
+	const float *pos = (const float *)xfmem.posMatrices + g_main_cp_state.matrix_index_a.PosNormalMtxIdx * 4;
+	const float *norm = (const float *)xfmem.normalMatrices + 3 * (g_main_cp_state.matrix_index_a.PosNormalMtxIdx & 31);
+
+	float4 matrices[6] = {};
+	memcpy(matrices, pos, 3*16);
+	memcpy(matrices[3], norm, 12);
+	memcpy(matrices[4], norm+3, 12);
+	memcpy(matrices[5], norm+6, 12);
+
+	if (s_draw_matrix_slots_used && !memcmp(GetDrawMatrix(draw_matrix_slot), matrices, sizeof(matrices)))
+		return;
+
+	if (s_draw_matrix_slots_used == ArraySize(constants.drawmatrices) / 6)
+	{
+		VertexManager::Flush();
+		s_draw_matrix_slots_used = 0;
+	}
+
+	draw_matrix_slot = s_draw_matrix_slots_used++;
+	memcpy(constants.drawmatrices[draw_matrix_slot * 6], matrices, sizeof(matrices));
+	dirty = true;
+}
+
+// Called after each flush. The current matrices move to the first slot, the next draw
+// may still be part of the flushed batch.
+void VertexShaderManager::ResetDrawMatrices()
+{
+	if (draw_matrix_slot)
+	{
+		memcpy(constants.drawmatrices[0], GetDrawMatrix(draw_matrix_slot), 6*16);
+		dirty = true;
+	}
+	s_draw_matrix_slots_used = std::min<u32>(s_draw_matrix_slots_used, 1);
+	draw_matrix_slot = 0;
+	s_batch_reads_xf_matrices = s_draw_reads_xf_matrices;
+}
+
+// Returns whether the pending batch doesn't depend on the xf memory in [start, end)
+// until it is flushed, so a write to it doesn't need to flush the batch.
+bool VertexShaderManager::IsXFWriteBatchable(u32 start, u32 end)
+{
+	if (!draw_matrix_batching || s_batch_reads_xf_matrices)
+		return false;
+
+	if (start >= XFMEM_NORMALMATRICES && end <= XFMEM_NORMALMATRICES_END)
+		return true;
+	if (end > XFMEM_POSMATRICES_END)
+		return false;
+
+	// The texture matrices are still taken from xf memory when flushing.
+	const u32 tex_mtx[8] = {
+		g_main_cp_state.matrix_index_a.Tex0MtxIdx, g_main_cp_state.matrix_index_a.Tex1MtxIdx,
+		g_main_cp_state.matrix_index_a.Tex2MtxIdx, g_main_cp_state.matrix_index_a.Tex3MtxIdx,
+		g_main_cp_state.matrix_index_b.Tex4MtxIdx, g_main_cp_state.matrix_index_b.Tex5MtxIdx,
+		g_main_cp_state.matrix_index_b.Tex6MtxIdx, g_main_cp_state.matrix_index_b.Tex7MtxIdx,
+	};
+	for (u32 idx : tex_mtx)
+	{
+		if (start < idx * 4 + 12 && end > idx * 4)
+			return false;
+	}
+	return true;
+}
+
 void VertexShaderManager::SetViewportChanged()
 {
 	bViewportChanged = true;
@@ -692,7 +786,11 @@ void VertexShaderManager::ResetView()
 
 void VertexShaderManager::TransformToClipSpace(const float* data, float* out, u32 MtxIdx)
 {
-	const float* world_matrix = (const float*)xfmem.posMatrices + (MtxIdx & 0x3f) * 4;
+	TransformToClipSpace(data, out, (const float*)xfmem.posMatrices + (MtxIdx & 0x3f) * 4);
+}
+
+void VertexShaderManager::TransformToClipSpace(const float* data, float* out, const float* world_matrix)
+{
 	// We use the projection matrix calculated by vertexShaderManager, because it
 	// includes any free look transformations.
 	// Make sure VertexManager::SetConstants() has been called first.
@@ -730,6 +828,10 @@ void VertexShaderManager::DoState(PointerWrap &p)
 	p.Do(bViewportChanged);
 
 	p.Do(constants);
+	p.Do(draw_matrix_slot);
+	p.Do(s_draw_matrix_slots_used);
+	p.Do(s_draw_reads_xf_matrices);
+	p.Do(s_batch_reads_xf_matrices);
 
 	if (p.GetMode() == PointerWrap::MODE_READ)
 	{
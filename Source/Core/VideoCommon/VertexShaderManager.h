@@ -39,7 +39,24 @@ public:
 	// NOTE: g_fProjectionMatrix must be up to date when this is called
 	//       (i.e. VertexShaderManager::SetConstants needs to be called before using this!)
 	static void TransformToClipSpace(const float* data, float* out, u32 mtxIdx);
+	static void TransformToClipSpace(const float* data, float* out, const float* world_matrix);
+
+	// Draw matrix batching: draws without per-vertex position matrix indices store the
+	// slot of a snapshot of their position/normal matrix in posmtx (VB_HAS_DRAWIDX), so
+	// changing that matrix between draws doesn't need a flush.
+	// SetDrawMatrix is called for each draw before its vertices are loaded.
+	static void SetDrawMatrix(u32 components);
+	static void ResetDrawMatrices();
+	static bool IsXFWriteBatchable(u32 start, u32 end);
+	static const float* GetDrawMatrix(u32 slot) { return constants.drawmatrices[slot * 6]; }
 
 	static VertexShaderConstants constants;
 	static bool dirty;
+
+	static bool draw_matrix_batching;
+	static u32 draw_matrix_slot;
+
+	// Set whenever state feeding the shader uid changes, so the backend only
+	// has to regenerate the uid when this is set.
+	static bool uid_dirty;
 };
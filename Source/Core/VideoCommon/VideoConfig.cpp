@@ -11,7 +11,10 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/Movie.h"
+#include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -23,6 +26,11 @@ void UpdateActiveConfig()
 	if (Movie::IsPlayingInput() && Movie::IsConfigSaved())
 		Movie::SetGraphicsConfig();
 	g_ActiveConfig = g_Config;
+
+	// Most of the shader uids depend on the active config as well.
+	PixelShaderManager::uid_dirty = true;
+	VertexShaderManager::uid_dirty = true;
+	GeometryShaderManager::uid_dirty = true;
 }
 
 VideoConfig::VideoConfig()
@@ -63,6 +71,7 @@ void VideoConfig::Load(const std::string& ini_file)
 	settings->Get("UseXFB", &bUseXFB, 0);
 	settings->Get("UseRealXFB", &bUseRealXFB, 0);
 	settings->Get("SafeTextureCacheColorSamples", &iSafeTextureCache_ColorSamples,128);
+	settings->Get("TextureCacheBudget", &iTextureCacheBudget, 0);
 	settings->Get("ShowFPS", &bShowFPS, false);
 	settings->Get("LogRenderTimeToFile", &bLogRenderTimeToFile, false);
 	settings->Get("OverlayStats", &bOverlayStats, false);
@@ -97,10 +106,16 @@ void VideoConfig::Load(const std::string& ini_file)
 
 	IniFile::Section* hacks = iniFile.GetOrCreateSection("Hacks");
 	hacks->Get("EFBAccessEnable", &bEFBAccessEnable, true);
+	hacks->Get("EFBAccessAsync", &bEFBAccessAsync, false);
 	hacks->Get("EFBCopyEnable", &bEFBCopyEnable, true);
 	hacks->Get("EFBToTextureEnable", &bCopyEFBToTexture, true);
 	hacks->Get("EFBScaledCopy", &bCopyEFBScaled, true);
+	hacks->Get("DeferEFBCopies", &bDeferEFBCopies, false);
 	hacks->Get("EFBEmulateFormatChanges", &bEFBEmulateFormatChanges, false);
+	hacks->Get("AsyncShaderCompilation", &bAsyncShaderCompilation, false);
+	hacks->Get("PrecompileShaders", &bPrecompileShaders, false);
+	hacks->Get("ParallelVertexLoading", &bParallelVertexLoading, false);
+	hacks->Get("DrawMatrixBatching", &bDrawMatrixBatching, false);
 
 	// Load common settings
 	iniFile.Load(File::GetUserPath(F_DOLPHINCONFIG_IDX));
@@ -149,6 +164,7 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video_Settings", "UseXFB", bUseXFB);
 	CHECK_SETTING("Video_Settings", "UseRealXFB", bUseRealXFB);
 	CHECK_SETTING("Video_Settings", "SafeTextureCacheColorSamples", iSafeTextureCache_ColorSamples);
+	CHECK_SETTING("Video_Settings", "TextureCacheBudget", iTextureCacheBudget);
 	CHECK_SETTING("Video_Settings", "HiresTextures", bHiresTextures);
 	CHECK_SETTING("Video_Settings", "ConvertHiresTextures", bConvertHiresTextures);
 	CHECK_SETTING("Video_Settings", "EnablePixelLighting", bEnablePixelLighting);
@@ -197,10 +213,16 @@ void VideoConfig::GameIniLoad()
 	CHECK_SETTING("Video_Stereoscopy", "StereoConvergenceMinimum", iStereoConvergenceMinimum);
 
 	CHECK_SETTING("Video_Hacks", "EFBAccessEnable", bEFBAccessEnable);
+	CHECK_SETTING("Video_Hacks", "EFBAccessAsync", bEFBAccessAsync);
 	CHECK_SETTING("Video_Hacks", "EFBCopyEnable", bEFBCopyEnable);
 	CHECK_SETTING("Video_Hacks", "EFBToTextureEnable", bCopyEFBToTexture);
 	CHECK_SETTING("Video_Hacks", "EFBScaledCopy", bCopyEFBScaled);
+	CHECK_SETTING("Video_Hacks", "DeferEFBCopies", bDeferEFBCopies);
 	CHECK_SETTING("Video_Hacks", "EFBEmulateFormatChanges", bEFBEmulateFormatChanges);
+	CHECK_SETTING("Video_Hacks", "AsyncShaderCompilation", bAsyncShaderCompilation);
+	CHECK_SETTING("Video_Hacks", "PrecompileShaders", bPrecompileShaders);
+	CHECK_SETTING("Video_Hacks", "ParallelVertexLoading", bParallelVertexLoading);
+	CHECK_SETTING("Video_Hacks", "DrawMatrixBatching", bDrawMatrixBatching);
 
 	CHECK_SETTING("Video", "ProjectionHack", iPhackvalue[0]);
 	CHECK_SETTING("Video", "PH_SZNear", iPhackvalue[1]);
@@ -251,6 +273,7 @@ void VideoConfig::Save(const std::string& ini_file)
 	settings->Set("UseXFB", bUseXFB);
 	settings->Set("UseRealXFB", bUseRealXFB);
 	settings->Set("SafeTextureCacheColorSamples", iSafeTextureCache_ColorSamples);
+	settings->Set("TextureCacheBudget", iTextureCacheBudget);
 	settings->Set("ShowFPS", bShowFPS);
 	settings->Set("LogRenderTimeToFile", bLogRenderTimeToFile);
 	settings->Set("OverlayStats", bOverlayStats);
@@ -285,10 +308,16 @@ void VideoConfig::Save(const std::string& ini_file)
 
 	IniFile::Section* hacks = iniFile.GetOrCreateSection("Hacks");
 	hacks->Set("EFBAccessEnable", bEFBAccessEnable);
+	hacks->Set("EFBAccessAsync", bEFBAccessAsync);
 	hacks->Set("EFBCopyEnable", bEFBCopyEnable);
 	hacks->Set("EFBToTextureEnable", bCopyEFBToTexture);
 	hacks->Set("EFBScaledCopy", bCopyEFBScaled);
+	hacks->Set("DeferEFBCopies", bDeferEFBCopies);
 	hacks->Set("EFBEmulateFormatChanges", bEFBEmulateFormatChanges);
+	hacks->Set("AsyncShaderCompilation", bAsyncShaderCompilation);
+	hacks->Set("PrecompileShaders", bPrecompileShaders);
+	hacks->Set("ParallelVertexLoading", bParallelVertexLoading);
+	hacks->Set("DrawMatrixBatching", bDrawMatrixBatching);
 
 	iniFile.Save(ini_file);
 }
@@ -111,18 +111,25 @@ struct VideoConfig final
 
 	// Hacks
 	bool bEFBAccessEnable;
+	bool bEFBAccessAsync;
 	bool bPerfQueriesEnable;
 
 	bool bEFBCopyEnable;
 	bool bEFBEmulateFormatChanges;
 	bool bCopyEFBToTexture;
 	bool bCopyEFBScaled;
+	bool bDeferEFBCopies;
 	int iSafeTextureCache_ColorSamples;
+	int iTextureCacheBudget; // in MiB, 0 for no limit
 	int iPhackvalue[3];
 	std::string sPhackvalue[2];
 	float fAspectRatioHackW, fAspectRatioHackH;
 	bool bEnablePixelLighting;
 	bool bFastDepthCalc;
+	bool bAsyncShaderCompilation;
+	bool bPrecompileShaders;
+	bool bParallelVertexLoading;
+	bool bDrawMatrixBatching;
 	int iLog; // CONF_ bits
 	int iSaveTargetId; // TODO: Should be dropped
 
@@ -2,6 +2,8 @@
 // Licensed under GPLv2
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/Common.h"
 #include "Core/HW/Memmap.h"
 #include "VideoCommon/CPMemory.h"
@@ -16,10 +18,31 @@
 
 static void XFMemWritten(u32 transferSize, u32 baseAddress)
 {
-	VertexManager::Flush();
+	// Batched draws have their own copy of the position and normal matrices.
+	if (!VertexShaderManager::IsXFWriteBatchable(baseAddress, baseAddress + transferSize))
+		VertexManager::Flush();
 	VertexShaderManager::InvalidateXFRange(baseAddress, baseAddress + transferSize);
 }
 
+// Flags the shader uids which are generated from the xf lighting and texgen state as dirty.
+static void SetShaderUidsDirty()
+{
+	VertexShaderManager::uid_dirty = true;
+	PixelShaderManager::uid_dirty = true;
+}
+
+// Returns whether any of the count registers starting at address differ from the
+// transferred values, which start at word data_index of src.
+static bool XFRegsChanged(u32 address, int count, DataReader src, u32 data_index)
+{
+	for (int i = 0; i < count; i++)
+	{
+		if (((u32*)&xfmem)[address + i] != src.Peek<u32>((data_index + i) * sizeof(u32)))
+			return true;
+	}
+	return false;
+}
+
 static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 {
 	u32 address = baseAddress;
@@ -52,7 +75,10 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 
 		case XFMEM_SETNUMCHAN:
 			if (xfmem.numChan.numColorChans != (newValue & 3))
+			{
 				VertexManager::Flush();
+				SetShaderUidsDirty();
+			}
 			break;
 
 		case XFMEM_SETCHAN0_AMBCOLOR: // Channel Ambient Color
@@ -84,12 +110,18 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 		case XFMEM_SETCHAN0_ALPHA: // Channel Alpha
 		case XFMEM_SETCHAN1_ALPHA:
 			if (((u32*)&xfmem)[address] != (newValue & 0x7fff))
+			{
 				VertexManager::Flush();
+				SetShaderUidsDirty();
+			}
 			break;
 
 		case XFMEM_DUALTEX:
 			if (xfmem.dualTexTrans.enabled != (newValue & 1))
+			{
 				VertexManager::Flush();
+				SetShaderUidsDirty();
+			}
 			break;
 
 
@@ -108,10 +140,13 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 		case XFMEM_SETVIEWPORT+3:
 		case XFMEM_SETVIEWPORT+4:
 		case XFMEM_SETVIEWPORT+5:
-			VertexManager::Flush();
-			VertexShaderManager::SetViewportChanged();
-			PixelShaderManager::SetViewportChanged();
-			GeometryShaderManager::SetViewportChanged();
+			if (XFRegsChanged(address, std::min<int>(XFMEM_SETVIEWPORT + 6 - address, transferSize), src, dataIndex))
+			{
+				VertexManager::Flush();
+				VertexShaderManager::SetViewportChanged();
+				PixelShaderManager::SetViewportChanged();
+				GeometryShaderManager::SetViewportChanged();
+			}
 
 			nextAddress = XFMEM_SETVIEWPORT + 6;
 			break;
@@ -123,16 +158,22 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 		case XFMEM_SETPROJECTION+4:
 		case XFMEM_SETPROJECTION+5:
 		case XFMEM_SETPROJECTION+6:
-			VertexManager::Flush();
-			VertexShaderManager::SetProjectionChanged();
-			GeometryShaderManager::SetProjectionChanged();
+			if (XFRegsChanged(address, std::min<int>(XFMEM_SETPROJECTION + 7 - address, transferSize), src, dataIndex))
+			{
+				VertexManager::Flush();
+				VertexShaderManager::SetProjectionChanged();
+				GeometryShaderManager::SetProjectionChanged();
+			}
 
 			nextAddress = XFMEM_SETPROJECTION + 7;
 			break;
 
 		case XFMEM_SETNUMTEXGENS: // GXSetNumTexGens
 			if (xfmem.numTexGen.numTexGens != (newValue & 15))
+			{
 				VertexManager::Flush();
+				SetShaderUidsDirty();
+			}
 			break;
 
 		case XFMEM_SETTEXMTXINFO:
@@ -143,7 +184,11 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 		case XFMEM_SETTEXMTXINFO+5:
 		case XFMEM_SETTEXMTXINFO+6:
 		case XFMEM_SETTEXMTXINFO+7:
-			VertexManager::Flush();
+			if (XFRegsChanged(address, std::min<int>(XFMEM_SETTEXMTXINFO + 8 - address, transferSize), src, dataIndex))
+			{
+				VertexManager::Flush();
+				SetShaderUidsDirty();
+			}
 
 			nextAddress = XFMEM_SETTEXMTXINFO + 8;
 			break;
@@ -156,7 +201,11 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
 		case XFMEM_SETPOSMTXINFO+5:
 		case XFMEM_SETPOSMTXINFO+6:
 		case XFMEM_SETPOSMTXINFO+7:
-			VertexManager::Flush();
+			if (XFRegsChanged(address, std::min<int>(XFMEM_SETPOSMTXINFO + 8 - address, transferSize), src, dataIndex))
+			{
+				VertexManager::Flush();
+				SetShaderUidsDirty();
+			}
 
 			nextAddress = XFMEM_SETPOSMTXINFO + 8;
 			break;
@@ -229,10 +278,19 @@ void LoadXFReg(u32 transferSize, u32 baseAddress, DataReader src)
 			transferSize = 0;
 		}
 
-		XFMemWritten(xfMemTransferSize, xfMemBase);
-		for (u32 i = 0; i < xfMemTransferSize; i++)
+		// Games often upload the same matrices and lights again for every draw,
+		// don't flush for those.
+		if (XFRegsChanged(xfMemBase, xfMemTransferSize, src, 0))
+		{
+			XFMemWritten(xfMemTransferSize, xfMemBase);
+			for (u32 i = 0; i < xfMemTransferSize; i++)
+			{
+				((u32*)&xfmem)[xfMemBase + i] = src.Read<u32>();
+			}
+		}
+		else
 		{
-			((u32*)&xfmem)[xfMemBase + i] = src.Read<u32>();
+			src.Skip<u32>(xfMemTransferSize);
 		}
 	}
 
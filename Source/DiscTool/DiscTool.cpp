@@ -0,0 +1,163 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/Common.h"
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Core/Host.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeCreator.h"
+
+// Stub out the host stuff that gets linked in with core, since this is just a simple cmdline tool.
+void Host_NotifyMapLoaded() {}
+void Host_RefreshDSPDebuggerWindow() {}
+void Host_Message(int) {}
+void* Host_GetRenderHandle() { return nullptr; }
+void Host_UpdateTitle(const std::string&) {}
+void Host_UpdateDisasmDialog() {}
+void Host_UpdateMainFrame() {}
+void Host_RequestRenderWindowSize(int, int) {}
+void Host_RequestFullscreen(bool) {}
+void Host_SetStartupDebuggingParameters() {}
+bool Host_UIHasFocus() { return false; }
+bool Host_RendererHasFocus() { return false; }
+bool Host_RendererIsFullscreen() { return false; }
+void Host_ConnectWiimote(int, bool) {}
+void Host_SetWiiMoteConnectionState(int) {}
+void Host_ShowVideoConfig(void*, const std::string&, const std::string&) {}
+
+static bool s_quiet = false;
+
+static bool ProgressCallback(const std::string& text, float percent, void* arg)
+{
+	if (!s_quiet)
+	{
+		printf("\r%s: %3i%% %-60s", (const char*)arg, (int)(percent * 100), text.c_str());
+		fflush(stdout);
+	}
+	return true;
+}
+
+static void PrintUsage()
+{
+	printf("USAGE: DiscTool [-?] [--help] [-f iso|gcz] [-s] [-b <BLOCK SIZE>] [-q] -o <OUTPUT> <INPUT>...\n");
+	printf("Converts GameCube and Wii disc images (ISO, GCZ, WBFS, CISO) to ISO or GCZ.\n");
+	printf("-? / --help: Prints this message\n");
+	printf("-f <FORMAT>: Output format, iso or gcz (default)\n");
+	printf("-s: Scrub Wii discs (fill unused clusters with 0xFF)\n");
+	printf("-b <BLOCK SIZE>: GCZ block size in bytes (default 16384)\n");
+	printf("-q: Don't print progress\n");
+	printf("-o <OUTPUT>: Output file, or a directory when converting several images\n");
+}
+
+int main(int argc, const char *argv[])
+{
+	if (argc == 1 || (argc == 2 && (!strcmp(argv[1], "--help") || (!strcmp(argv[1], "-?")))))
+	{
+		PrintUsage();
+		return 0;
+	}
+
+	DiscIO::BlobFormat format = DiscIO::BLOB_FORMAT_GCZ;
+	bool scrub = false;
+	int block_size = 16384;
+	std::string output_name;
+	std::vector<std::string> input_names;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-f") && i + 1 < argc)
+		{
+			const char* name = argv[++i];
+			if (!strcmp(name, "iso"))
+				format = DiscIO::BLOB_FORMAT_PLAIN;
+			else if (!strcmp(name, "gcz"))
+				format = DiscIO::BLOB_FORMAT_GCZ;
+			else
+			{
+				printf("ERROR: Unknown output format %s.\n", name);
+				return 1;
+			}
+		}
+		else if (!strcmp(argv[i], "-s"))
+			scrub = true;
+		else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+			block_size = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-q"))
+			s_quiet = true;
+		else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+			output_name = argv[++i];
+		else
+		{
+			if (!File::Exists(argv[i]))
+			{
+				printf("ERROR: Input path %s does not exist.\n", argv[i]);
+				return 1;
+			}
+			input_names.push_back(argv[i]);
+		}
+	}
+
+	if (input_names.empty() || output_name.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (block_size <= 0)
+	{
+		printf("ERROR: Invalid block size.\n");
+		return 1;
+	}
+
+	const bool output_is_directory = File::IsDirectory(output_name);
+	if (input_names.size() > 1 && !output_is_directory)
+	{
+		printf("ERROR: The output has to be a directory when converting several images.\n");
+		return 1;
+	}
+
+	int failed = 0;
+	for (const std::string& input_name : input_names)
+	{
+		std::string output_file = output_name;
+		if (output_is_directory)
+		{
+			std::string name;
+			SplitPath(input_name, nullptr, &name, nullptr);
+			output_file += DIR_SEP + name + (format == DiscIO::BLOB_FORMAT_GCZ ? ".gcz" : ".iso");
+		}
+
+		bool scrub_input = false;
+		if (scrub)
+		{
+			std::unique_ptr<DiscIO::IVolume> volume(DiscIO::CreateVolumeFromFilename(input_name));
+			scrub_input = volume && volume->IsWiiDisc();
+			if (!scrub_input)
+				printf("%s is not a Wii disc, converting it without scrubbing.\n", input_name.c_str());
+		}
+
+		bool success = DiscIO::ConvertBlob(input_name, output_file, format, scrub_input, block_size,
+		                                   &ProgressCallback, const_cast<char*>(input_name.c_str()));
+		if (!s_quiet)
+			printf("\n");
+
+		if (!success)
+		{
+			printf("ERROR: Failed to convert %s to %s.\n", input_name.c_str(), output_file.c_str());
+			failed++;
+		}
+	}
+
+	return failed ? 1 : 0;
+}
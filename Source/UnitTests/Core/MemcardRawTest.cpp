@@ -0,0 +1,165 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/GCMemcard.h"
+#include "Core/HW/GCMemcardRaw.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+class MemcardRawTest : public testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		SConfig::Init();
+		SConfig::GetInstance().m_LocalCoreStartupParameter.bEnableMemcardSaving = true;
+
+		m_filename = File::GetCurrentDir() + "/MemcardRawTest.raw";
+		File::Delete(m_filename);
+		File::Delete(m_filename + ".journal");
+
+		// The card is written out completely when it's destroyed for the first time.
+		MemoryCard card(m_filename, 0, MemCard59Mb);
+	}
+
+	virtual void TearDown()
+	{
+		File::Delete(m_filename);
+		File::Delete(m_filename + ".journal");
+		SConfig::Shutdown();
+	}
+
+	std::vector<u8> ReadBlockFromFile(u32 block)
+	{
+		std::vector<u8> data(BLOCK_SIZE);
+		File::IOFile f(m_filename, "rb");
+		f.Seek((u64)block * BLOCK_SIZE, SEEK_SET);
+		f.ReadBytes(data.data(), data.size());
+		return data;
+	}
+
+	void WriteBlockToFile(u32 block, u8 value)
+	{
+		std::vector<u8> data(BLOCK_SIZE, value);
+		File::IOFile f(m_filename, "r+b");
+		f.Seek((u64)block * BLOCK_SIZE, SEEK_SET);
+		f.WriteBytes(data.data(), data.size());
+	}
+
+	// Same format as MemoryCard::WriteJournal
+	std::vector<u8> MakeJournal(u32 block, u8 value)
+	{
+		std::vector<u8> journal(3 * sizeof(u32) + BLOCK_SIZE, value);
+		const u32 header[] = { 0x4A434D44, 1, block };
+		memcpy(journal.data(), header, sizeof(header));
+		u32 hash = HashAdler32(journal.data(), journal.size());
+		journal.insert(journal.end(), (u8*)&hash, (u8*)&hash + sizeof(hash));
+		return journal;
+	}
+
+	void WriteJournal(const std::vector<u8>& journal)
+	{
+		File::IOFile f(m_filename + ".journal", "wb");
+		f.WriteBytes(journal.data(), journal.size());
+	}
+
+	std::string m_filename;
+};
+
+TEST_F(MemcardRawTest, OnlyDirtyBlocksAreWritten)
+{
+	{
+		MemoryCard card(m_filename, 0, MemCard59Mb);
+
+		// Changed behind the card's back, a full write would revert this.
+		WriteBlockToFile(10, 0x11);
+
+		std::vector<u8> data(BLOCK_SIZE, 0x22);
+		card.Write(5 * BLOCK_SIZE, BLOCK_SIZE, data.data());
+	}
+
+	EXPECT_EQ(std::vector<u8>(BLOCK_SIZE, 0x22), ReadBlockFromFile(5));
+	EXPECT_EQ(std::vector<u8>(BLOCK_SIZE, 0x11), ReadBlockFromFile(10));
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+}
+
+TEST_F(MemcardRawTest, CompleteJournalIsReplayed)
+{
+	WriteJournal(MakeJournal(7, 0x33));
+
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+
+	std::vector<u8> data(BLOCK_SIZE);
+	card.Read(7 * BLOCK_SIZE, BLOCK_SIZE, data.data());
+	EXPECT_EQ(std::vector<u8>(BLOCK_SIZE, 0x33), data);
+	EXPECT_EQ(std::vector<u8>(BLOCK_SIZE, 0x33), ReadBlockFromFile(7));
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+}
+
+TEST_F(MemcardRawTest, TruncatedJournalIsDiscarded)
+{
+	const std::vector<u8> before = ReadBlockFromFile(7);
+	std::vector<u8> journal = MakeJournal(7, 0x33);
+	journal.resize(journal.size() - 100);
+	WriteJournal(journal);
+
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+
+	std::vector<u8> data(BLOCK_SIZE);
+	card.Read(7 * BLOCK_SIZE, BLOCK_SIZE, data.data());
+	EXPECT_EQ(before, data);
+	EXPECT_EQ(before, ReadBlockFromFile(7));
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+}
+
+TEST_F(MemcardRawTest, CorruptJournalIsDiscarded)
+{
+	const std::vector<u8> before = ReadBlockFromFile(7);
+	std::vector<u8> journal = MakeJournal(7, 0x33);
+	journal[100] ^= 0xFF;
+	WriteJournal(journal);
+
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+
+	std::vector<u8> data(BLOCK_SIZE);
+	card.Read(7 * BLOCK_SIZE, BLOCK_SIZE, data.data());
+	EXPECT_EQ(before, data);
+	EXPECT_EQ(before, ReadBlockFromFile(7));
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+}
+
+TEST_F(MemcardRawTest, LoadingStateWritesWholeCard)
+{
+	const std::vector<u8> before = ReadBlockFromFile(10);
+	{
+		MemoryCard card(m_filename, 0, MemCard59Mb);
+
+		u8* ptr = nullptr;
+		PointerWrap measure(&ptr, PointerWrap::MODE_MEASURE);
+		card.DoState(measure);
+		std::vector<u8> state((size_t)ptr);
+
+		ptr = state.data();
+		PointerWrap save(&ptr, PointerWrap::MODE_WRITE);
+		card.DoState(save);
+
+		WriteBlockToFile(10, 0x11);
+
+		ptr = state.data();
+		PointerWrap load(&ptr, PointerWrap::MODE_READ);
+		card.DoState(load);
+	}
+
+	EXPECT_EQ(before, ReadBlockFromFile(10));
+}
@@ -0,0 +1,149 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "Common/FileUtil.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/CompressedBlob.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+static const int BLOCK_SIZE = 0x4000;
+
+static bool NullCallback(const std::string& text, float percent, void* arg)
+{
+	return true;
+}
+
+class CompressedBlobTest : public testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		m_plain = File::GetCurrentDir() + "/CompressedBlobTest.iso";
+		m_compressed = File::GetCurrentDir() + "/CompressedBlobTest.gcz";
+		m_num_cores = cpu_info.num_cores;
+
+		// Compressible blocks, random blocks which will be stored and a partial block at the end
+		std::mt19937 rng(42);
+		m_data.resize(BLOCK_SIZE * 37 + 1234);
+		for (size_t i = 0; i < m_data.size(); i++)
+		{
+			if ((i / BLOCK_SIZE) % 3 == 0)
+				m_data[i] = (u8)rng();
+			else
+				m_data[i] = (u8)(i / 97);
+		}
+
+		File::IOFile f(m_plain, "wb");
+		f.WriteBytes(m_data.data(), m_data.size());
+	}
+
+	virtual void TearDown()
+	{
+		cpu_info.num_cores = m_num_cores;
+		File::Delete(m_plain);
+		File::Delete(m_compressed);
+	}
+
+	void CheckReads()
+	{
+		std::unique_ptr<DiscIO::IBlobReader> reader(DiscIO::CreateBlobReader(m_compressed));
+		ASSERT_TRUE(reader != nullptr);
+		EXPECT_EQ(m_data.size(), reader->GetDataSize());
+
+		// Everything at once, unaligned and a single byte
+		std::vector<u8> buffer(m_data.size());
+		ASSERT_TRUE(reader->Read(0, m_data.size(), buffer.data()));
+		EXPECT_TRUE(buffer == m_data);
+
+		ASSERT_TRUE(reader->Read(1000, BLOCK_SIZE * 9, buffer.data()));
+		EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + BLOCK_SIZE * 9, m_data.begin() + 1000));
+
+		ASSERT_TRUE(reader->Read(BLOCK_SIZE * 20 + 5, 1, buffer.data()));
+		EXPECT_EQ(m_data[BLOCK_SIZE * 20 + 5], buffer[0]);
+	}
+
+	std::string m_plain;
+	std::string m_compressed;
+	std::vector<u8> m_data;
+	int m_num_cores;
+};
+
+TEST_F(CompressedBlobTest, RoundTrip)
+{
+	ASSERT_TRUE(DiscIO::CompressFileToBlob(m_plain, m_compressed, 0, BLOCK_SIZE, NullCallback));
+	CheckReads();
+}
+
+TEST_F(CompressedBlobTest, OutputDoesNotDependOnThreads)
+{
+	std::string single, multi;
+
+	cpu_info.num_cores = 1;
+	ASSERT_TRUE(DiscIO::CompressFileToBlob(m_plain, m_compressed, 0, BLOCK_SIZE, NullCallback));
+	ASSERT_TRUE(File::ReadFileToString(m_compressed, single));
+	File::Delete(m_compressed);
+
+	cpu_info.num_cores = 4;
+	ASSERT_TRUE(DiscIO::CompressFileToBlob(m_plain, m_compressed, 0, BLOCK_SIZE, NullCallback));
+	ASSERT_TRUE(File::ReadFileToString(m_compressed, multi));
+
+	EXPECT_TRUE(single == multi);
+
+	// Also decompresses adjacent blocks on several threads
+	CheckReads();
+}
+
+TEST_F(CompressedBlobTest, SmallSequentialReads)
+{
+	ASSERT_TRUE(DiscIO::CompressFileToBlob(m_plain, m_compressed, 0, BLOCK_SIZE, NullCallback));
+
+	std::unique_ptr<DiscIO::CompressedBlobReader> reader(DiscIO::CompressedBlobReader::Create(m_compressed));
+	ASSERT_TRUE(reader != nullptr);
+
+	// Like the DVD interface streaming a file, which makes the following blocks get read ahead
+	std::vector<u8> buffer(m_data.size());
+	u64 num_reads = 0;
+	for (u64 offset = 0; offset < m_data.size(); offset += 2048)
+	{
+		u64 size = std::min<u64>(2048, m_data.size() - offset);
+		ASSERT_TRUE(reader->Read(offset, size, &buffer[offset]));
+		num_reads++;
+	}
+	EXPECT_TRUE(buffer == m_data);
+
+	DiscIO::SectorReader::CacheStats stats = reader->GetCacheStats();
+	EXPECT_EQ(num_reads, stats.hits + stats.read_ahead_hits + stats.misses);
+
+	// Going backwards is served from the cache
+	ASSERT_TRUE(reader->Read(m_data.size() - BLOCK_SIZE * 3, 16, buffer.data()));
+	EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + 16, m_data.end() - BLOCK_SIZE * 3));
+	EXPECT_EQ(stats.hits + 1, reader->GetCacheStats().hits);
+}
+
+TEST_F(CompressedBlobTest, ConvertBetweenFormats)
+{
+	cpu_info.num_cores = 4;
+	ASSERT_TRUE(DiscIO::CompressFileToBlob(m_plain, m_compressed, 0, BLOCK_SIZE, NullCallback));
+
+	// Any readable image can be the input, including a GCZ with a different block size
+	std::string recompressed = File::GetCurrentDir() + "/CompressedBlobTest2.gcz";
+	ASSERT_TRUE(DiscIO::ConvertBlob(m_compressed, recompressed, DiscIO::BLOB_FORMAT_GCZ, false, BLOCK_SIZE * 2, NullCallback));
+	File::Delete(m_plain);
+	ASSERT_TRUE(DiscIO::ConvertBlob(recompressed, m_plain, DiscIO::BLOB_FORMAT_PLAIN, false, 0, NullCallback));
+	File::Delete(recompressed);
+
+	std::string plain;
+	ASSERT_TRUE(File::ReadFileToString(m_plain, plain));
+	ASSERT_EQ(m_data.size(), plain.size());
+	EXPECT_TRUE(std::equal(m_data.begin(), m_data.end(), (const u8*)plain.data()));
+}
@@ -0,0 +1,62 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/FileBlob.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+class FileBlobTest : public testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		m_filename = File::GetCurrentDir() + "/FileBlobTest.iso";
+
+		m_data.resize(0x12345);
+		for (size_t i = 0; i < m_data.size(); i++)
+			m_data[i] = (u8)(i * 7 + (i >> 8));
+
+		File::IOFile f(m_filename, "wb");
+		f.WriteBytes(m_data.data(), m_data.size());
+	}
+
+	virtual void TearDown()
+	{
+		File::Delete(m_filename);
+	}
+
+	std::string m_filename;
+	std::vector<u8> m_data;
+};
+
+TEST_F(FileBlobTest, MappedMatchesPlain)
+{
+	std::unique_ptr<DiscIO::IBlobReader> mapped(DiscIO::MappedFileReader::Create(m_filename));
+	std::unique_ptr<DiscIO::IBlobReader> plain(DiscIO::PlainFileReader::Create(m_filename));
+	ASSERT_TRUE(plain != nullptr);
+	if (!mapped)
+		return;  // 32-bit host
+
+	EXPECT_EQ(plain->GetDataSize(), mapped->GetDataSize());
+
+	std::vector<u8> a(m_data.size()), b(m_data.size());
+	ASSERT_TRUE(mapped->Read(0, m_data.size(), a.data()));
+	EXPECT_TRUE(a == m_data);
+
+	ASSERT_TRUE(mapped->Read(0x1001, 0x800, a.data()));
+	ASSERT_TRUE(plain->Read(0x1001, 0x800, b.data()));
+	EXPECT_TRUE(std::equal(a.begin(), a.begin() + 0x800, b.begin()));
+
+	// Reads past the end fail like they do with fread
+	EXPECT_FALSE(mapped->Read(m_data.size() - 4, 8, a.data()));
+	EXPECT_FALSE(plain->Read(m_data.size() - 4, 8, b.data()));
+}
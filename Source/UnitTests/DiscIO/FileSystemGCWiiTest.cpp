@@ -0,0 +1,107 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/Filesystem.h"
+#include "DiscIO/VolumeGC.h"
+#include "TestUtils/MemoryBlobReader.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+static const u32 FST_OFFSET = 0x1000;
+
+class FileSystemGCWiiTest : public testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		m_disc.resize(0x6000);
+		for (size_t i = 0; i < m_disc.size(); i++)
+			m_disc[i] = (u8)(i * 13);
+
+		// A GameCube disc with a small FST, where Audio/Inner.ast overlaps Audio/Bgm.ast
+		Write32(0x1c, 0xC2339F3D);
+		const char names[] = "opening.bnr\0Audio\0Bgm.ast\0Inner.ast\0zero.bin";
+		const u32 entries[6][3] =
+		{
+			{ 0x01000000, 0, 6 },
+			{ 0, 0x2000, 0x100 },
+			{ 0x0100000c, 0, 5 },
+			{ 0x12, 0x3000, 0x1000 },
+			{ 0x1a, 0x3800, 0x100 },
+			{ 0x24, 0x5000, 0 },
+		};
+		Write32(0x424, FST_OFFSET);
+		Write32(0x428, sizeof(entries) + sizeof(names));
+		for (int i = 0; i < 6; i++)
+			for (int j = 0; j < 3; j++)
+				Write32(FST_OFFSET + i * 0xC + j * 4, entries[i][j]);
+		memcpy(&m_disc[FST_OFFSET + sizeof(entries)], names, sizeof(names));
+
+		m_volume.reset(new DiscIO::CVolumeGC(new TestUtils::MemoryBlobReader(m_disc)));
+		m_filesystem.reset(DiscIO::CreateFileSystem(m_volume.get()));
+	}
+
+	void Write32(u32 offset, u32 value)
+	{
+		value = Common::swap32(value);
+		memcpy(&m_disc[offset], &value, sizeof(value));
+	}
+
+	std::vector<u8> m_disc;
+	std::unique_ptr<DiscIO::IVolume> m_volume;
+	std::unique_ptr<DiscIO::IFileSystem> m_filesystem;
+};
+
+TEST_F(FileSystemGCWiiTest, FileList)
+{
+	ASSERT_TRUE(m_filesystem != nullptr);
+
+	std::vector<const DiscIO::SFileInfo*> files;
+	ASSERT_EQ(6u, m_filesystem->GetFileList(files));
+	EXPECT_EQ("opening.bnr", files[1]->m_FullPath);
+	EXPECT_EQ("Audio/", files[2]->m_FullPath);
+	EXPECT_EQ("Audio/Inner.ast", files[4]->m_FullPath);
+	EXPECT_EQ("zero.bin", files[5]->m_FullPath);
+}
+
+TEST_F(FileSystemGCWiiTest, FindByPath)
+{
+	ASSERT_TRUE(m_filesystem != nullptr);
+
+	EXPECT_EQ(0x1000u, m_filesystem->GetFileSize("AUDIO/bgm.AST"));
+	EXPECT_EQ(0u, m_filesystem->GetFileSize("Audio/"));
+	EXPECT_EQ(0u, m_filesystem->GetFileSize("missing.bin"));
+
+	std::vector<u8> buffer(0x100);
+	ASSERT_EQ(0x100u, m_filesystem->ReadFile("opening.bnr", buffer.data(), buffer.size()));
+	EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_disc.begin() + 0x2000));
+}
+
+TEST_F(FileSystemGCWiiTest, FindByOffset)
+{
+	ASSERT_TRUE(m_filesystem != nullptr);
+
+	EXPECT_EQ("opening.bnr", m_filesystem->GetFileName(0x2000));
+	EXPECT_EQ("opening.bnr", m_filesystem->GetFileName(0x20ff));
+	EXPECT_EQ("", m_filesystem->GetFileName(0x2100));
+
+	// The first of the overlapping files wins, also past the start of the later one
+	EXPECT_EQ("Audio/Bgm.ast", m_filesystem->GetFileName(0x3000));
+	EXPECT_EQ("Audio/Bgm.ast", m_filesystem->GetFileName(0x3850));
+	EXPECT_EQ("Audio/Bgm.ast", m_filesystem->GetFileName(0x3fff));
+	EXPECT_EQ("", m_filesystem->GetFileName(0x4000));
+
+	// Neither directories nor empty files contain anything
+	EXPECT_EQ("", m_filesystem->GetFileName(0x3));
+	EXPECT_EQ("", m_filesystem->GetFileName(0x5000));
+}
@@ -0,0 +1,102 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include <polarssl/aes.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/CPUDetect.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/VolumeWiiCrypted.h"
+#include "TestUtils/MemoryBlobReader.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+static const u64 DATA_OFFSET = 0x20000;
+static const u32 CLUSTER_SIZE = 0x8000;
+static const u32 CLUSTER_DATA_SIZE = 0x7C00;
+static const u32 NUM_CLUSTERS = 24;
+
+class VolumeWiiCryptedTest : public testing::Test
+{
+protected:
+	virtual void SetUp()
+	{
+		m_saved_cpu_info = cpu_info;
+
+		std::mt19937 rng(7);
+		for (u8& b : m_key)
+			b = (u8)rng();
+
+		aes_context ctx;
+		aes_setkey_enc(&ctx, m_key, 128);
+
+		// Every cluster has a random IV in its header
+		m_plain.resize(NUM_CLUSTERS * CLUSTER_DATA_SIZE);
+		std::vector<u8> disc(DATA_OFFSET + NUM_CLUSTERS * CLUSTER_SIZE);
+		for (u8& b : m_plain)
+			b = (u8)rng();
+		for (u32 i = 0; i < NUM_CLUSTERS; i++)
+		{
+			u8* cluster = &disc[DATA_OFFSET + i * CLUSTER_SIZE];
+			for (u32 j = 0; j < 0x400; j++)
+				cluster[j] = (u8)rng();
+
+			u8 iv[16];
+			memcpy(iv, cluster + 0x3D0, sizeof(iv));
+			aes_crypt_cbc(&ctx, AES_ENCRYPT, CLUSTER_DATA_SIZE, iv, &m_plain[i * CLUSTER_DATA_SIZE], cluster + 0x400);
+		}
+
+		m_volume.reset(new DiscIO::CVolumeWiiCrypted(new TestUtils::MemoryBlobReader(disc), 0, m_key));
+	}
+
+	virtual void TearDown()
+	{
+		cpu_info = m_saved_cpu_info;
+	}
+
+	void CheckRead(u64 offset, u64 size)
+	{
+		std::vector<u8> buffer(size);
+		ASSERT_TRUE(m_volume->Read(offset, size, buffer.data(), true));
+		EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_plain.begin() + offset)) << offset << " " << size;
+	}
+
+	u8 m_key[16];
+	std::vector<u8> m_plain;
+	std::unique_ptr<DiscIO::CVolumeWiiCrypted> m_volume;
+	CPUInfo m_saved_cpu_info;
+};
+
+TEST_F(VolumeWiiCryptedTest, InterleavedReads)
+{
+	// Two files being read at the same time
+	for (u64 i = 0; i < 8; i++)
+	{
+		CheckRead(0x100 + i * 0x1800, 0x1800);
+		CheckRead(CLUSTER_DATA_SIZE * 12 + 0x20 + i * 0x1800, 0x1800);
+	}
+}
+
+TEST_F(VolumeWiiCryptedTest, LargeReads)
+{
+	cpu_info.num_cores = 1;
+	CheckRead(0, m_plain.size());
+	CheckRead(CLUSTER_DATA_SIZE * 3 + 5, CLUSTER_DATA_SIZE * 9);
+
+	cpu_info.num_cores = 4;
+	CheckRead(0, m_plain.size());
+	CheckRead(CLUSTER_DATA_SIZE, CLUSTER_DATA_SIZE * 17 + 0x123);
+}
+
+TEST_F(VolumeWiiCryptedTest, SoftwareDecryption)
+{
+	cpu_info.bAES = false;
+	CheckRead(0, m_plain.size());
+	CheckRead(0x1234, 0x4321);
+}
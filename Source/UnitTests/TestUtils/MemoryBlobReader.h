@@ -0,0 +1,35 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "DiscIO/Blob.h"
+
+namespace TestUtils
+{
+
+// Serves a disc image out of memory, for tests that build their images on the fly.
+class MemoryBlobReader : public DiscIO::IBlobReader
+{
+public:
+	MemoryBlobReader(const std::vector<u8>& data) : m_data(data) {}
+	u64 GetRawSize() const override { return m_data.size(); }
+	u64 GetDataSize() const override { return m_data.size(); }
+	bool Read(u64 offset, u64 size, u8* out_ptr) override
+	{
+		if (offset + size > m_data.size())
+			return false;
+		memcpy(out_ptr, &m_data[offset], (size_t)size);
+		return true;
+	}
+
+private:
+	std::vector<u8> m_data;
+};
+
+}
@@ -0,0 +1,183 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <random>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/BPMemLoader.h"
+#include "VideoBackends/Software/Tev.h"
+#include "VideoBackends/Software/TextureSampler.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/TextureDecoder.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+static s16 Clamp(s16 value, bool clamp)
+{
+	if (clamp)
+		return value > 255 ? 255 : (value < 0 ? 0 : value);
+	else
+		return value > 1023 ? 1023 : (value < -1024 ? -1024 : value);
+}
+
+#ifdef _M_X86
+TEST(TevTest, RegularCombinersMatchScalar)
+{
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<int> value(-32768, 32767);
+
+	// Every bias, op, clamp and shift combination for color and alpha, with random operands.
+	for (u32 mode = 0; mode < 3 * 2 * 2 * 4 * 3 * 2 * 2 * 4; mode++)
+	{
+		u32 m = mode;
+		TevStageCombiner::ColorCombiner cc;
+		TevStageCombiner::AlphaCombiner ac;
+		cc.hex = 0;
+		ac.hex = 0;
+		cc.bias = m % 3; m /= 3;
+		cc.op = m % 2; m /= 2;
+		cc.clamp = m % 2; m /= 2;
+		cc.shift = m % 4; m /= 4;
+		ac.bias = m % 3; m /= 3;
+		ac.op = m % 2; m /= 2;
+		ac.clamp = m % 2; m /= 2;
+		ac.shift = m % 4;
+
+		for (int i = 0; i < 256; i++)
+		{
+			s16 a[4], b[4], c[4], d[4];
+			Tev::InputRegType inputs[4];
+			for (int comp = 0; comp < 4; comp++)
+			{
+				a[comp] = value(rng);
+				b[comp] = value(rng);
+				c[comp] = value(rng);
+				d[comp] = value(rng);
+
+				// Tev::Draw masks the register values the same way
+				inputs[comp].a = a[comp];
+				inputs[comp].b = b[comp];
+				inputs[comp].c = c[comp];
+				inputs[comp].d = d[comp];
+			}
+
+			// Include the extremes of the masked operands
+			if (i == 0)
+			{
+				for (int comp = 0; comp < 4; comp++)
+				{
+					a[comp] = b[comp] = c[comp] = 255;
+					d[comp] = 1023;
+					inputs[comp].a = inputs[comp].b = inputs[comp].c = 255;
+					inputs[comp].d = 1023;
+				}
+			}
+			else if (i == 1)
+			{
+				for (int comp = 0; comp < 4; comp++)
+				{
+					a[comp] = b[comp] = c[comp] = 0;
+					d[comp] = -1024;
+					inputs[comp].a = inputs[comp].b = inputs[comp].c = 0;
+					inputs[comp].d = -1024;
+				}
+			}
+
+			s16 expected[4];
+			Tev::DrawColorRegular(cc, inputs, expected);
+			Tev::DrawAlphaRegular(ac, inputs, expected);
+			for (int comp = Tev::BLU_C; comp <= Tev::RED_C; comp++)
+				expected[comp] = Clamp(expected[comp], cc.clamp);
+			expected[Tev::ALP_C] = Clamp(expected[Tev::ALP_C], ac.clamp);
+
+			s16 result[4];
+			Tev::DrawRegularSSE2(cc, ac, a, b, c, d, result);
+
+			for (int comp = 0; comp < 4; comp++)
+				ASSERT_EQ(expected[comp], result[comp]) << "color 0x" << std::hex << cc.hex << " alpha 0x" << ac.hex << " channel " << comp;
+		}
+	}
+}
+#endif
+
+class TexelCacheTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		memset((void*)&bpmem, 0, sizeof(bpmem));
+
+		// A 64x64 CI8 texture with an RGB5A3 palette, both preloaded into TMEM
+		FourTexUnits& texUnit = bpmem.tex[0];
+		texUnit.texImage0[0].width = 63;
+		texUnit.texImage0[0].height = 63;
+		texUnit.texImage0[0].format = GX_TF_C8;
+		texUnit.texImage1[0].image_type = 1;
+		texUnit.texImage1[0].tmem_even = 0;
+		texUnit.texTlut[0].tmem_offset = 256;
+		texUnit.texTlut[0].tlut_format = GX_TL_RGB5A3;
+		texUnit.texMode0[0].min_filter = 6; // linear, with linear mipmaps
+		texUnit.texMode0[0].mag_filter = 1;
+		texUnit.texMode0[0].wrap_s = 1;
+		texUnit.texMode0[0].wrap_t = 2;
+		texUnit.texMode1[0].max_lod = 6 << 4;
+
+		FillTexMem(0);
+	}
+
+	void FillTexMem(u32 seed)
+	{
+		std::mt19937 rng(seed);
+		for (u32 i = 0; i < TMEM_SIZE; i++)
+			texMem[i] = (u8)rng();
+	}
+
+	void ExpectCachedSamplesMatch(TextureSampler::TexelCache* cache, u32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<s32> coord(-64 * 128, 128 * 128);
+		std::uniform_int_distribution<s32> lod(0, 6 << 4);
+
+		for (int i = 0; i < 20000; i++)
+		{
+			s32 s = coord(rng);
+			s32 t = coord(rng);
+			s32 l = lod(rng);
+			bool linear = (i & 1) != 0;
+
+			u8 expected[4], result[4];
+			TextureSampler::Sample(s, t, l, linear, 0, expected);
+			TextureSampler::Sample(s, t, l, linear, 0, result, cache);
+			ASSERT_EQ(0, memcmp(expected, result, sizeof(result))) << "s " << s << " t " << t << " lod " << l;
+		}
+	}
+};
+
+TEST_F(TexelCacheTest, MatchesUncachedSampling)
+{
+	std::unique_ptr<TextureSampler::TexelCache> cache(new TextureSampler::TexelCache);
+	ExpectCachedSamplesMatch(cache.get(), 1);
+	// Sampling again hits the cache
+	ExpectCachedSamplesMatch(cache.get(), 1);
+}
+
+TEST_F(TexelCacheTest, Invalidation)
+{
+	std::unique_ptr<TextureSampler::TexelCache> cache(new TextureSampler::TexelCache);
+	ExpectCachedSamplesMatch(cache.get(), 2);
+
+	// New texture data
+	FillTexMem(3);
+	TextureSampler::InvalidateTexelCaches();
+	ExpectCachedSamplesMatch(cache.get(), 2);
+
+	// A different texture replaces the cached one without an explicit invalidation
+	bpmem.tex[0].texImage0[0].format = GX_TF_I8;
+	ExpectCachedSamplesMatch(cache.get(), 2);
+	bpmem.tex[0].texTlut[0].tmem_offset = 300;
+	bpmem.tex[0].texImage0[0].format = GX_TF_C8;
+	ExpectCachedSamplesMatch(cache.get(), 2);
+}
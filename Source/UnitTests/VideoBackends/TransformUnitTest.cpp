@@ -0,0 +1,60 @@
+// Copyright 2014 Dolphin Emulator Project
+// Licensed under GPLv2
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <random>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/TransformUnit.h"
+#include "VideoCommon/XFMemory.h"
+
+#include <gtest/gtest.h>  // NOLINT
+
+static void CheckBatchMatchesSingle(u32 projection_type, bool mixed_matrices)
+{
+	std::mt19937 rng(projection_type * 2 + mixed_matrices);
+	std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+
+	float* matrices = (float*)xfmem.posMatrices;
+	for (int i = 0; i < 256; i++)
+		matrices[i] = value(rng);
+	for (float& p : xfmem.projection.rawProjection)
+		p = value(rng);
+	xfmem.projection.type = projection_type;
+
+	const int count = 23;
+	InputVertexData src[count];
+	OutputVertexData single[count];
+	OutputVertexData batch[count];
+
+	for (int i = 0; i < count; i++)
+	{
+		src[i].posMtx = mixed_matrices ? (u8)((i % 3) * 4) : 8;
+		src[i].position.x = value(rng);
+		src[i].position.y = value(rng);
+		src[i].position.z = value(rng);
+		TransformUnit::TransformPosition(&src[i], &single[i]);
+	}
+
+	TransformUnit::TransformPositions(src, batch, count);
+
+	for (int i = 0; i < count; i++)
+	{
+		EXPECT_EQ(0, memcmp(&single[i].mvPosition, &batch[i].mvPosition, sizeof(Vec3))) << "vertex " << i;
+		EXPECT_EQ(0, memcmp(&single[i].projectedPosition, &batch[i].projectedPosition, sizeof(Vec4))) << "vertex " << i;
+	}
+}
+
+TEST(TransformUnitTest, BatchedPositionsMatchPerspective)
+{
+	CheckBatchMatchesSingle(GX_PERSPECTIVE, false);
+	CheckBatchMatchesSingle(GX_PERSPECTIVE, true);
+}
+
+TEST(TransformUnitTest, BatchedPositionsMatchOrthographic)
+{
+	CheckBatchMatchesSingle(GX_ORTHOGRAPHIC, false);
+	CheckBatchMatchesSingle(GX_ORTHOGRAPHIC, true);
+}
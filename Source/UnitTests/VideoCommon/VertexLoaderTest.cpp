@@ -1,8 +1,20 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
 #include <unordered_set>
 
 #include "Common/Common.h"
+#include "Common/CPUDetect.h"
+#include "Common/Timer.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/VertexLoader.h"
 #include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
+#ifdef _M_X86_64
+#include "VideoCommon/VertexLoaderX64.h"
+#endif
 
 // Needs to be included later because it defines a TEST macro that conflicts
 // with a TEST method definition in x64Emitter.h.
@@ -168,6 +180,108 @@ TEST_F(VertexLoaderTest, PositionDirectU16XY)
 	delete loader;
 }
 
+TEST_F(VertexLoaderTest, PositionIndexSkip)
+{
+	m_vtx_desc.PosMatIdx = 1;
+	m_vtx_desc.Position = INDEX8;
+	m_vtx_attr.g0.PosElements = 1;  // XYZ
+	m_vtx_attr.g0.PosFormat = 4;    // Float
+
+	static float positions[2][3];
+	for (int i = 0; i < 2; ++i)
+		for (int j = 0; j < 3; ++j)
+			positions[i][j] = Common::FromBigEndian(float(i * 3 + j));
+	u8* arraybase = cached_arraybases[ARRAY_POSITION];
+	u32 stride = g_main_cp_state.array_strides[ARRAY_POSITION];
+	cached_arraybases[ARRAY_POSITION] = (u8*)positions;
+	g_main_cp_state.array_strides[ARRAY_POSITION] = sizeof(positions[0]);
+
+	Input<u8>(5); Input<u8>(0);
+	Input<u8>(6); Input<u8>(0xFF);
+	Input<u8>(7); Input<u8>(1);
+	Input<u8>(8); Input<u8>(0xFF);
+
+	std::unique_ptr<VertexLoaderBase> loaders[2];
+	loaders[0].reset(new VertexLoader(m_vtx_desc, m_vtx_attr));
+#ifdef _M_X86_64
+	if (cpu_info.bSSSE3)
+		loaders[1].reset(new VertexLoaderX64(m_vtx_desc, m_vtx_attr));
+#endif
+
+	for (int i = 0; i < 2; ++i)
+	{
+		if (!loaders[i])
+			continue;
+
+		const PortableVertexDeclaration& decl = loaders[i]->m_native_vtx_decl;
+		memset(output_memory, 0xCD, 3 * decl.stride);
+		ResetPointers();
+		EXPECT_EQ(2, loaders[i]->CountSkippedVertices(src.GetPointer(), 4));
+		ASSERT_EQ(2, loaders[i]->RunVertices(src, dst, 4, 7));
+
+		for (int v = 0; v < 2; ++v)
+		{
+			m_output_pos = v * decl.stride + decl.posmtx.offset;
+			ExpectOut<u8>(5 + 2 * v);
+			m_output_pos = v * decl.stride + decl.position.offset;
+			ExpectOut(v * 3 + 0.0f); ExpectOut(v * 3 + 1.0f); ExpectOut(v * 3 + 2.0f);
+		}
+	}
+
+	// Parallel decoding puts the next chunk right behind the last vertex, so the
+	// JIT must neither write anything for the ones it skips nor store past the end.
+	if (loaders[1])
+	{
+		const PortableVertexDeclaration& decl = loaders[1]->m_native_vtx_decl;
+		for (int i = 0; i < decl.stride; ++i)
+			EXPECT_EQ(0xCD, output_memory[2 * decl.stride + i]);
+	}
+
+	cached_arraybases[ARRAY_POSITION] = arraybase;
+	g_main_cp_state.array_strides[ARRAY_POSITION] = stride;
+}
+
+TEST_F(VertexLoaderTest, DrawMatrixSlot)
+{
+	m_vtx_desc.Position = 1;        // Direct
+	m_vtx_attr.g0.PosElements = 1;  // XYZ
+	m_vtx_attr.g0.PosFormat = 4;    // Float
+
+	VertexShaderManager::draw_matrix_batching = true;
+	VertexShaderManager::draw_matrix_slot = 5;
+
+	std::unique_ptr<VertexLoaderBase> loaders[2];
+	loaders[0].reset(new VertexLoader(m_vtx_desc, m_vtx_attr));
+#ifdef _M_X86_64
+	if (cpu_info.bSSSE3)
+		loaders[1].reset(new VertexLoaderX64(m_vtx_desc, m_vtx_attr));
+#endif
+
+	Input(1.0f); Input(2.0f); Input(4.0f);
+
+	for (int i = 0; i < 2; ++i)
+	{
+		if (!loaders[i])
+			continue;
+
+		const PortableVertexDeclaration& decl = loaders[i]->m_native_vtx_decl;
+		EXPECT_EQ((u32)(VB_HAS_DRAWIDX | VB_HAS_POSMTXIDX), loaders[i]->m_native_components);
+		ASSERT_TRUE(decl.posmtx.enable);
+		ASSERT_EQ(3 * sizeof(float), (u32)loaders[i]->m_VertexSize);
+
+		ResetPointers();
+		ASSERT_EQ(1, loaders[i]->RunVertices(src, dst, 1, 7));
+
+		m_output_pos = decl.posmtx.offset;
+		ExpectOut<u32>(5);
+		m_output_pos = decl.position.offset;
+		ExpectOut(1.0f); ExpectOut(2.0f); ExpectOut(4.0f);
+	}
+
+	VertexShaderManager::draw_matrix_batching = false;
+	VertexShaderManager::draw_matrix_slot = 0;
+}
+
 TEST_F(VertexLoaderTest, PositionDirectFloatXYZSpeed)
 {
 	m_vtx_desc.Position = 1;        // Direct
@@ -273,3 +387,111 @@ TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
 	}
 	delete loader;
 }
+
+// Runs every direct attribute format through the generic loader and the JIT one,
+// checks that they agree and reports the throughput of both.
+TEST_F(VertexLoaderTest, FormatSpeed)
+{
+	struct Format
+	{
+		const char* name;
+		int attribute; // 0: position, 1: normal, 2: color, 3: texcoord
+		int format;
+		int elements;
+	};
+	static const Format formats[] = {
+		{ "P u8 XY", 0, 0, 0 }, { "P s8 XYZ", 0, 1, 1 }, { "P u16 XYZ", 0, 2, 1 },
+		{ "P s16 XY", 0, 3, 0 }, { "P s16 XYZ", 0, 3, 1 }, { "P flt XYZ", 0, 4, 1 },
+		{ "N s8", 1, 1, 0 }, { "N s16", 1, 3, 0 }, { "N flt", 1, 4, 0 },
+		{ "NBT s8", 1, 1, 1 }, { "NBT s16", 1, 3, 1 }, { "NBT flt", 1, 4, 1 },
+		{ "C 565", 2, 0, 0 }, { "C 888", 2, 1, 0 }, { "C 888x", 2, 2, 0 },
+		{ "C 4444", 2, 3, 1 }, { "C 6666", 2, 4, 1 }, { "C 8888", 2, 5, 1 },
+		{ "T u8 S", 3, 0, 0 }, { "T s8 ST", 3, 1, 1 }, { "T u16 ST", 3, 2, 1 },
+		{ "T s16 ST", 3, 3, 1 }, { "T flt ST", 3, 4, 1 },
+	};
+	static const int num_vertices = 100000;
+	static const int iterations = 10;
+
+	// Keep the generic loader away from the bounding box emulation.
+	const bool supports_bbox = g_ActiveConfig.backend_info.bSupportsBBox;
+	g_ActiveConfig.backend_info.bSupportsBBox = true;
+
+	// Small values only, so that no float input turns into a NaN.
+	for (size_t i = 0; i < sizeof(input_memory); ++i)
+		input_memory[i] = (i * 7) & 0x3F;
+
+	for (const Format& format : formats)
+	{
+		memset(&m_vtx_desc, 0, sizeof(m_vtx_desc));
+		memset(&m_vtx_attr, 0, sizeof(m_vtx_attr));
+		m_vtx_desc.Position = 1;
+		m_vtx_attr.g0.PosElements = 1;
+		m_vtx_attr.g0.PosFormat = 4;
+		m_vtx_attr.g0.PosFrac = 3;
+		m_vtx_attr.g0.ByteDequant = 1;
+
+		switch (format.attribute)
+		{
+		case 0:
+			m_vtx_attr.g0.PosFormat = format.format;
+			m_vtx_attr.g0.PosElements = format.elements;
+			break;
+		case 1:
+			m_vtx_desc.Normal = 1;
+			m_vtx_attr.g0.NormalFormat = format.format;
+			m_vtx_attr.g0.NormalElements = format.elements;
+			break;
+		case 2:
+			m_vtx_desc.Color0 = 1;
+			m_vtx_attr.g0.Color0Comp = format.format;
+			m_vtx_attr.g0.Color0Elements = format.elements;
+			break;
+		case 3:
+			m_vtx_desc.Tex0Coord = 1;
+			m_vtx_attr.g0.Tex0CoordFormat = format.format;
+			m_vtx_attr.g0.Tex0CoordElements = format.elements;
+			m_vtx_attr.g0.Tex0Frac = 5;
+			break;
+		}
+
+		std::unique_ptr<VertexLoaderBase> loaders[2];
+		loaders[0].reset(new VertexLoader(m_vtx_desc, m_vtx_attr));
+#ifdef _M_X86_64
+		if (cpu_info.bSSSE3)
+			loaders[1].reset(new VertexLoaderX64(m_vtx_desc, m_vtx_attr));
+#endif
+
+		size_t output_size = num_vertices * loaders[0]->m_native_vtx_decl.stride;
+		for (int i = 0; i < 2; ++i)
+		{
+			if (!loaders[i])
+				continue;
+
+			u64 start = Common::Timer::GetTimeUs();
+			for (int j = 0; j < iterations; ++j)
+			{
+				ResetPointers();
+				loaders[i]->RunVertices(src, dst, num_vertices, 7);
+			}
+			u64 elapsed = std::max<u64>(Common::Timer::GetTimeUs() - start, 1);
+
+			// Reported through the XML output (--gtest_output=xml), whose
+			// attribute names can't contain spaces.
+			std::string key = format.name + (" " + loaders[i]->GetName());
+			std::replace(key.begin(), key.end(), ' ', '_');
+			RecordProperty(key, std::to_string((u64)num_vertices * iterations * 1000000 / elapsed));
+
+			// Keep the generic output around in the second half of the buffer.
+			if (i == 0)
+				memcpy(output_memory + sizeof(output_memory) / 2, output_memory, output_size);
+		}
+
+		if (loaders[1])
+		{
+			EXPECT_EQ(loaders[0]->m_native_vtx_decl.stride, loaders[1]->m_native_vtx_decl.stride) << format.name;
+			EXPECT_EQ(0, memcmp(output_memory, output_memory + sizeof(output_memory) / 2, output_size)) << format.name;
+		}
+	}
+
+	g_ActiveConfig.backend_info.bSupportsBBox = supports_bbox;
+}